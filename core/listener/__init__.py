@@ -5,12 +5,52 @@ from loguru import logger
 from .build import listener
 from lib.listener.utils import load_config
 
+def result_to_dict(result):
+    return {
+        "start_time": result.start_time,
+        "end_time": result.end_time,
+        "result": result.result,
+        "decode_duration": result.decode_duration,
+        "audio_duration": result.audio_duration,
+        "rtf": round(result.rtf, 3)
+    }
+
+def queue_stats_to_dict(stats):
+    return {
+        "depth": stats.depth,
+        "capacity": stats.capacity,
+        "max_depth": stats.max_depth,
+        "merged_windows": stats.merged_windows,
+        "dropped_windows": stats.dropped_windows
+    }
+
+# 监听会话：一路音频流（如远程客户端）独立检测与识别，共享已加载的模型与解码工作线程
+class ListenerSession():
+
+    def __init__(self, session):
+        self.session = session
+
+    # 输入int16 PCM（bytes或int16 numpy数组）
+    def input(self, data):
+        self.session.input(data)
+
+    def get_queue_stats(self):
+        return queue_stats_to_dict(self.session.get_queue_stats())
+
+    def output(self, callback):
+        self.session.output(lambda result: callback(result_to_dict(result)))
+
+    def partial_output(self, callback):
+        self.session.partial_output(lambda result: callback(result_to_dict(result)))
+
 class Listener():
 
     def __init__(self):
         self.initialized: bool = False
         self.input_accept_callback: function = None
         self.output_callback: function = None
+        self.partial_output_callback: function = None
+        self.capture_thread_pinned: bool = False
 
     def initialize(self, config_path):
         logger.info(f"listener version: {listener.get_version()}")
@@ -25,7 +65,27 @@ class Listener():
             config.vad_max_sampling_duration if hasattr(config, "vad_max_sampling_duration") else 18000,
             config.sampling_amplification_factor if hasattr(config, "sampling_amplification_factor") else 4.0,
             config.chunk_size if hasattr(config, "chunk_size") else 16,
-            config.num_threads if hasattr(config, "num_threads") else 1
+            config.num_threads if hasattr(config, "num_threads") else 1,
+            config.decode_queue_capacity if hasattr(config, "decode_queue_capacity") else 64
+        )
+        # 按CPU拓扑规划线程放置
+        placement = listener.configure_placement(
+            config.inference_cluster if hasattr(config, "inference_cluster") else "auto",
+            config.pin_audio_thread if hasattr(config, "pin_audio_thread") else True
+        )
+        logger.info(f"listener thread placement: {placement}")
+        # 优化模型缓存与预热
+        cache_dir_path = config.optimized_model_cache_dir if hasattr(config, "optimized_model_cache_dir") else ""
+        listener.configure_model_cache(
+            path.join(path.dirname(__file__), '../../', cache_dir_path) if cache_dir_path else "",
+            config.warmup if hasattr(config, "warmup") else True
+        )
+        # 解码工作线程（所有会话共享）
+        listener.configure_decode_workers(config.decode_workers if hasattr(config, "decode_workers") else 1)
+        # 跨会话VAD批推理
+        listener.configure_vad_batching(
+            config.vad_batch_size if hasattr(config, "vad_batch_size") else 1,
+            config.vad_batch_delay if hasattr(config, "vad_batch_delay") else 4
         )
         # 加载模型
         self.load_models(config.model_dir_path)
@@ -52,16 +112,24 @@ class Listener():
             return
         listener.input(data)
 
+    # 创建新的监听会话（如服务多个麦克风或远程客户端），无需重新加载模型
+    def create_session(self):
+        if not self.initialized:
+            raise RuntimeError("listener  has not been initialized")
+        return ListenerSession(listener.create_session())
+
+    # 采集到解码的队列统计：队列深度、合并与丢弃的窗口数
+    def get_queue_stats(self):
+        return queue_stats_to_dict(listener.get_queue_stats())
+
     def output(self, callback):
         self.output_callback = callback
-        listener.output(lambda result: self.output_callback({
-            "start_time": result.start_time,
-            "end_time": result.end_time,
-            "result": result.result,
-            "decode_duration": result.decode_duration,
-            "audio_duration": result.audio_duration,
-            "rtf": round(result.rtf, 3)
-        }))
+        listener.output(lambda result: self.output_callback(result_to_dict(result)))
+
+    # 中间结果：用户仍在说话时按块输出当前识别文本
+    def partial_output(self, callback):
+        self.partial_output_callback = callback
+        listener.partial_output(lambda result: self.partial_output_callback(result_to_dict(result)))
 
     def create_capture_stream(self):
         self.capture_target = PyAudio()
@@ -84,5 +152,9 @@ class Listener():
         self.capture_stream = None
 
     def capture_callback(self, input_data, frame_cout, time_info, status):
+        # 采集回调线程由监听器创建的音频流持有，首次回调时绑定到音频专用核心
+        if not self.capture_thread_pinned:
+            listener.pin_capture_thread()
+            self.capture_thread_pinned = True
         self.input(input_data)
         return (input_data, paContinue)
@@ -45,6 +45,10 @@ class AsrModel {
 
   virtual std::shared_ptr<AsrModel> Copy() const = 0;
 
+  // Run the encoder and rescoring once with representative shapes, so that
+  // the first utterance is decoded at steady-state latency
+  virtual void WarmUp(int feature_dim, int chunk_size) {}
+
  protected:
   virtual void ForwardEncoderFunc(
       const std::vector<std::vector<float>>& chunk_feats,
@@ -21,23 +21,34 @@
 #include <memory>
 #include <utility>
 
+#include "utils/onnx_model_cache.h"
 #include "utils/string.h"
 
 namespace wenet {
 
 Ort::Env OnnxAsrModel::env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "");
 Ort::SessionOptions OnnxAsrModel::session_options_ = Ort::SessionOptions();
+std::string OnnxAsrModel::optimized_model_cache_dir_;
 std::vector<Ort::AllocatedStringPtr> input_node_name_allocated_strings;
 std::vector<Ort::AllocatedStringPtr> output_node_name_allocated_strings;
 
-void OnnxAsrModel::InitEngineThreads(int num_threads) {
+void OnnxAsrModel::InitEngineThreads(int num_threads,
+                                     const std::string& thread_affinities) {
   session_options_.SetIntraOpNumThreads(num_threads);
+  if (!thread_affinities.empty()) {
+    session_options_.AddConfigEntry("session.intra_op_thread_affinities",
+                                    thread_affinities.c_str());
+  }
   session_options_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
   session_options_.DisableCpuMemArena();
   session_options_.DisableMemPattern();
   session_options_.DisableProfiling();
 }
 
+void OnnxAsrModel::SetOptimizedModelCacheDir(const std::string& cache_dir) {
+  optimized_model_cache_dir_ = cache_dir;
+}
+
 void OnnxAsrModel::GetInputOutputInfo(
     const std::shared_ptr<Ort::Session>& session,
     std::vector<const char*>* in_names, std::vector<const char*>* out_names) {
@@ -91,21 +102,14 @@ void OnnxAsrModel::Read(const std::string& model_dir) {
 
   // 1. Load sessions
   try {
-#ifdef _MSC_VER
-    encoder_session_ = std::make_shared<Ort::Session>(
-        env_, ToWString(encoder_onnx_path).c_str(), session_options_);
-    rescore_session_ = std::make_shared<Ort::Session>(
-        env_, ToWString(rescore_onnx_path).c_str(), session_options_);
-    ctc_session_ = std::make_shared<Ort::Session>(
-        env_, ToWString(ctc_onnx_path).c_str(), session_options_);
-#else
-    encoder_session_ = std::make_shared<Ort::Session>(
-        env_, encoder_onnx_path.c_str(), session_options_);
-    rescore_session_ = std::make_shared<Ort::Session>(
-        env_, rescore_onnx_path.c_str(), session_options_);
-    ctc_session_ = std::make_shared<Ort::Session>(env_, ctc_onnx_path.c_str(),
-                                                  session_options_);
-#endif
+    encoder_session_ = CreateCachedSession(env_, encoder_onnx_path,
+                                           session_options_,
+                                           optimized_model_cache_dir_);
+    rescore_session_ = CreateCachedSession(env_, rescore_onnx_path,
+                                           session_options_,
+                                           optimized_model_cache_dir_);
+    ctc_session_ = CreateCachedSession(env_, ctc_onnx_path, session_options_,
+                                       optimized_model_cache_dir_);
   } catch (std::exception const& e) {
     LOG(ERROR) << "error when load onnx model: " << e.what();
     exit(0);
@@ -193,6 +197,27 @@ std::shared_ptr<AsrModel> OnnxAsrModel::Copy() const {
   return asr_model;
 }
 
+void OnnxAsrModel::WarmUp(int feature_dim, int chunk_size) {
+  int saved_chunk_size = chunk_size_;
+  chunk_size_ = chunk_size > 0 ? chunk_size : 16;
+  Reset();
+  // One full first chunk through encoder and ctc
+  std::vector<std::vector<float>> feats(num_frames_for_chunk(false),
+                                        std::vector<float>(feature_dim, 0.0f));
+  std::vector<std::vector<float>> ctc_prob;
+  ForwardEncoder(feats, &ctc_prob);
+  // Rescore a short hypothesis against the encoder output
+  int vocab_size = std::max(eos_, 2);
+  std::vector<std::vector<int>> hyps(1);
+  for (int i = 0; i < chunk_size_ / 2; ++i) {
+    hyps[0].push_back(1 + i % (vocab_size - 1));
+  }
+  std::vector<float> scores;
+  AttentionRescoring(hyps, 0.0f, &scores);
+  chunk_size_ = saved_chunk_size;
+  Reset();
+}
+
 void OnnxAsrModel::Reset() {
   offset_ = 0;
   encoder_outs_.clear();
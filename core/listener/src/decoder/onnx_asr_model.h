@@ -32,7 +32,13 @@ namespace wenet {
 
 class OnnxAsrModel : public AsrModel {
  public:
-  static void InitEngineThreads(int num_threads = 1);
+  // thread_affinities: "session.intra_op_thread_affinities" value, empty to
+  // leave intra-op threads unpinned
+  static void InitEngineThreads(int num_threads = 1,
+                                const std::string& thread_affinities = "");
+  // Directory of ORT-optimized models reused across boots, empty to
+  // optimize on every load
+  static void SetOptimizedModelCacheDir(const std::string& cache_dir);
 
  public:
   OnnxAsrModel() = default;
@@ -43,6 +49,7 @@ class OnnxAsrModel : public AsrModel {
                           float reverse_weight,
                           std::vector<float>* rescoring_score) override;
   std::shared_ptr<AsrModel> Copy() const override;
+  void WarmUp(int feature_dim, int chunk_size) override;
   void GetInputOutputInfo(const std::shared_ptr<Ort::Session>& session,
                           std::vector<const char*>* in_names,
                           std::vector<const char*>* out_names);
@@ -65,6 +72,7 @@ class OnnxAsrModel : public AsrModel {
   //  One Env must be created before using any other Onnxruntime functionality.
   static Ort::Env env_;  // shared environment across threads.
   static Ort::SessionOptions session_options_;
+  static std::string optimized_model_cache_dir_;
   std::shared_ptr<Ort::Session> encoder_session_ = nullptr;
   std::shared_ptr<Ort::Session> rescore_session_ = nullptr;
   std::shared_ptr<Ort::Session> ctc_session_ = nullptr;
@@ -124,10 +124,10 @@ std::shared_ptr<DecodeOptions> InitDecodeOptionsFromFlags() {
   return decode_config;
 }
 
-std::shared_ptr<DecodeResource> InitDecodeResource(std::string modelDirPath, std::string unitPath, int16_t numThreads) {
+std::shared_ptr<DecodeResource> InitDecodeResource(std::string modelDirPath, std::string unitPath, int16_t numThreads, const std::string& threadAffinities = "") {
   auto resource = std::make_shared<DecodeResource>();
   LOG(INFO) << "Reading onnx model ";
-  OnnxAsrModel::InitEngineThreads(numThreads);
+  OnnxAsrModel::InitEngineThreads(numThreads, threadAffinities);
   auto model = std::make_shared<OnnxAsrModel>();
   model->Read(modelDirPath);
   resource->model = model;
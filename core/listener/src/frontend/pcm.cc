@@ -0,0 +1,50 @@
+#include "frontend/pcm.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace wenet {
+
+void ConvertPcm16(const int16_t* pcm, size_t size, float gain, float* out) {
+  size_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  const float32x4_t scale = vdupq_n_f32(gain);
+  for (; i + 8 <= size; i += 8) {
+    int16x8_t samples = vld1q_s16(pcm + i);
+    float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+    float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+    vst1q_f32(out + i, vmulq_f32(low, scale));
+    vst1q_f32(out + i + 4, vmulq_f32(high, scale));
+  }
+#elif defined(__AVX2__)
+  const __m256 scale = _mm256_set1_ps(gain);
+  for (; i + 16 <= size; i += 16) {
+    __m256i samples =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pcm + i));
+    __m256i low = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(samples));
+    __m256i high = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(samples, 1));
+    _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale));
+    _mm256_storeu_ps(out + i + 8,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale));
+  }
+#elif defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(gain);
+  for (; i + 8 <= size; i += 8) {
+    __m128i samples =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pcm + i));
+    // Sign-extend by placing each sample in the high half and shifting back
+    __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+    __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+  }
+#endif
+  for (; i < size; i++) {
+    out[i] = static_cast<float>(pcm[i]) * gain;
+  }
+}
+
+}  // namespace wenet
@@ -0,0 +1,16 @@
+#ifndef FRONTEND_PCM_H_
+#define FRONTEND_PCM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wenet {
+
+// Convert int16 pcm to float and apply gain in a single pass, vectorized with
+// NEON, AVX2 or SSE2 when available. The output keeps the int16 scale
+// expected by Fbank, e.g. gain 1.0 maps 32767 to 32767.0f.
+void ConvertPcm16(const int16_t* pcm, size_t size, float gain, float* out);
+
+}  // namespace wenet
+
+#endif  // FRONTEND_PCM_H_
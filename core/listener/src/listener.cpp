@@ -1,13 +1,19 @@
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <utility>
 #include <thread>
-#include <queue>
 
 #include "decoder/params.h"
+#include "frontend/pcm.h"
+#include "utils/blocking_queue.h"
+#include "utils/cpu_topology.h"
+#include "utils/spsc_queue.h"
 #include "utils/string.h"
 #include "utils/timer.h"
 #include "utils/utils.h"
 #include "vad/vad.h"
+#include "vad/vad_batcher.h"
 
 #include "listener.hpp"
 
@@ -22,33 +28,37 @@ namespace listener
     const std::string VERSION = "";
 #endif
 
-    std::shared_ptr<VadIterator> vad;
+    std::shared_ptr<VadIterator> vadModel; // 加载VAD模型的原型实例，各会话共享其推理会话
+    std::shared_ptr<VadBatcher> vadBatcher; // 各会话VAD推理的跨流批处理器，未启用时为空
     std::shared_ptr<wenet::DecodeOptions> decodeConfig;
     std::shared_ptr<wenet::FeaturePipelineConfig> featureConfig;
-    std::shared_ptr<wenet::FeaturePipeline> featurePipeline;
-    std::shared_ptr<wenet::AsrDecoder> decoder;
-    std::queue<SampledData> decodeQueue;
-    std::vector<float> samplingData;
-    std::function<void(const DecodeResult&)> callback;
-    int64_t samplingStartTime = 0;
-    bool isSampling = false;
-    std::mutex mtx;
-    std::condition_variable cv;
+    std::shared_ptr<wenet::DecodeResource> decodeResource; // 各会话共享的模型与解码资源
+    std::shared_ptr<ListenerSession> defaultSession;
+    std::function<void(const DecodeResult&)> defaultCallback;
+    std::function<void(const DecodeResult&)> defaultPartialCallback;
+    wenet::BlockingQueue<std::shared_ptr<ListenerSession>> readySessions; // 有待解码采样块的会话
     int sampleRate = 16000;
     int vadWindowFrameSize = 64;
     double vadThreshold = 0.6f;
     int vadMaxSamplingDuration = 180000;
     float samplingAmplificationFactor = 4.0;
     int16_t numThreads = 1;
+    int decodeQueueCapacity = 64;
+    int numDecodeWorkers = 1;
+    int vadMaxBatchSize = 1;
+    int vadMaxBatchDelay = 4;
+    wenet::ThreadPlacement placement;
+    std::string optimizedModelCacheDir;
+    bool warmupModels = false;
 
-    void processDecode();
+    void processDecode(int workerIndex);
 
     std::string getVersion()
     {
         return VERSION;
     }
 
-    void init(int _sampleRate, int _vadWindowFrameSize, double _vadThreshold, int _vadMaxSamplingDuration, float _samplingAmplificationFactor, int16_t chunkSize, int16_t _numThreads)
+    void init(int _sampleRate, int _vadWindowFrameSize, double _vadThreshold, int _vadMaxSamplingDuration, float _samplingAmplificationFactor, int16_t chunkSize, int16_t _numThreads, int _decodeQueueCapacity)
     {
         google::InitGoogleLogging("");
         sampleRate = _sampleRate;
@@ -57,133 +67,383 @@ namespace listener
         vadMaxSamplingDuration = _vadMaxSamplingDuration;
         samplingAmplificationFactor = _samplingAmplificationFactor;
         numThreads = _numThreads;
-        vad = std::make_shared<VadIterator>(sampleRate, vadWindowFrameSize, vadThreshold, 0, 0);
+        decodeQueueCapacity = std::max(_decodeQueueCapacity, 2);
+        vadModel = std::make_shared<VadIterator>(sampleRate, vadWindowFrameSize, vadThreshold, 0, 0);
         decodeConfig = wenet::InitDecodeOptionsFromFlags();
         decodeConfig->chunk_size = chunkSize;
         featureConfig = wenet::InitFeaturePipelineConfigFromFlags();
         featureConfig->sample_rate = sampleRate;
-        std::thread decodeThread(processDecode);
-        decodeThread.detach();
+        configurePlacement("auto", true);
+    }
+
+    std::string configurePlacement(const std::string &inferenceCluster, bool pinAudio)
+    {
+        wenet::PlacementOptions options;
+        options.inference_cluster = inferenceCluster;
+        options.pin_audio = pinAudio;
+        placement = wenet::PlanThreadPlacement(wenet::ReadCpuClusters(), numThreads, options);
+        std::string description = placement.Describe();
+        LOG(INFO) << "listener thread placement: " << description;
+        return description;
+    }
+
+    void configureModelCache(const std::string &cacheDirPath, bool warmup)
+    {
+        optimizedModelCacheDir = cacheDirPath;
+        warmupModels = warmup;
+    }
+
+    void configureDecodeWorkers(int numWorkers)
+    {
+        numDecodeWorkers = std::max(numWorkers, 1);
+    }
+
+    void configureVadBatching(int maxBatchSize, int maxDelayMs)
+    {
+        vadMaxBatchSize = std::max(maxBatchSize, 1);
+        vadMaxBatchDelay = std::max(maxDelayMs, 0);
     }
 
     void loadModels(const std::string &modelDirPath, const std::string &unitPath)
     {
-        vad->loadModel(modelDirPath + "/vad.onnx", 1, 1);
-        std::shared_ptr<wenet::DecodeResource> decodeResource = wenet::InitDecodeResource(modelDirPath, unitPath, numThreads);
+        vadModel->loadModel(modelDirPath + "/vad.onnx", 1, 1, optimizedModelCacheDir);
+        if (vadMaxBatchSize > 1)
+        {
+            vadBatcher = std::make_shared<VadBatcher>(vadMaxBatchSize, vadMaxBatchDelay);
+        }
+        wenet::OnnxAsrModel::SetOptimizedModelCacheDir(optimizedModelCacheDir);
+        // 解码工作线程作为推理线程，其余推理线程由ORT按亲和性配置绑定
+        int16_t intraThreads = placement.inference_cpus.empty() ? numThreads : static_cast<int16_t>(placement.inference_cpus.size());
+        decodeResource = wenet::InitDecodeResource(modelDirPath, unitPath, intraThreads, wenet::FormatIntraOpAffinities(placement.inference_cpus));
+        // 各会话以代表性形状预先推理，首句识别即达到稳态延迟
+        if (warmupModels)
+        {
+            wenet::Timer timer;
+            vadModel->warmUp();
+            decodeResource->model->WarmUp(featureConfig->num_bins, decodeConfig->chunk_size);
+            LOG(INFO) << "listener warm-up: " << timer.Elapsed() << "ms";
+        }
+        for (int i = 0; i < numDecodeWorkers; i++)
+        {
+            std::thread decodeThread(processDecode, i);
+            decodeThread.detach();
+        }
+        defaultSession = createSession();
+        defaultSession->output(defaultCallback);
+        defaultSession->partialOutput(defaultPartialCallback);
+    }
+
+    std::shared_ptr<ListenerSession> createSession()
+    {
+        if (decodeResource == nullptr)
+        {
+            throw std::runtime_error("listener models have not been loaded");
+        }
+        return std::make_shared<ListenerSession>();
+    }
+
+    ListenerSession::ListenerSession()
+    {
+        vad.reset(new VadIterator(sampleRate, vadWindowFrameSize, vadThreshold, 0, 0));
+        vad->shareModel(*vadModel);
+        vad->setBatcher(vadBatcher);
         featurePipeline = std::make_shared<wenet::FeaturePipeline>(*featureConfig);
-        decoder = std::make_shared<wenet::AsrDecoder>(featurePipeline, decodeResource, *decodeConfig);
+        decoder.reset(new wenet::AsrDecoder(featurePipeline, decodeResource, *decodeConfig));
+        decodeQueue.reset(new wenet::SpscQueue<SampledData>(decodeQueueCapacity));
     }
 
+    ListenerSession::~ListenerSession() = default;
+
     void input(const std::string &raw)
     {
-        int numSamples = raw.size() / 2;
-        int windowSamples = vadWindowFrameSize * (sampleRate / 1000);
+        input(reinterpret_cast<const int16_t *>(raw.data()), raw.size() / 2);
+    }
 
-        if (numSamples < windowSamples)
+    void input(const int16_t *samples, size_t numSamples)
+    {
+        if (defaultSession == nullptr)
         {
-            throw std::runtime_error("number of samples is less than the required window samples.");
+            throw std::runtime_error("listener models have not been loaded");
         }
+        defaultSession->input(samples, numSamples);
+    }
 
-        for (int j = 0; j < numSamples; j += windowSamples)
+    bool pinCaptureThread()
+    {
+        return wenet::SetCurrentThreadAffinity(placement.audio_cpus);
+    }
+
+    QueueStats getQueueStats()
+    {
+        return defaultSession != nullptr ? defaultSession->getQueueStats() : QueueStats{};
+    }
+
+    void output(const std::function<void(const DecodeResult&)>& _callback)
+    {
+        defaultCallback = _callback;
+        if (defaultSession != nullptr)
         {
-            std::vector<float> inputData;
-            for (int i = j * 2; i < (j + windowSamples) * 2; i += 2)
-            {
-                char lowByte = raw[i];
-                char highByte = raw[i + 1];
-                int16_t int16Value = static_cast<int16_t>(lowByte) | (static_cast<int16_t>(highByte) << 8);
-                inputData.push_back(static_cast<float>(int16Value) / 32768 * samplingAmplificationFactor);
-            }
+            defaultSession->output(_callback);
+        }
+    }
+
+    void partialOutput(const std::function<void(const DecodeResult&)>& _callback)
+    {
+        defaultPartialCallback = _callback;
+        if (defaultSession != nullptr)
+        {
+            defaultSession->partialOutput(_callback);
+        }
+    }
 
+    void ListenerSession::input(const int16_t *samples, size_t numSamples)
+    {
+        size_t windowSamples = vadWindowFrameSize * (sampleRate / 1000);
+        // 语音段结束后不再产生采样块，溢出缓冲（可能含语音段结束标记）在每次输入时尝试发布，避免最终结果被推迟到下一段语音
+        if (overflowPending && flushOverflow())
+        {
+            schedule();
+        }
+
+        // 转换与放大在一次向量化遍历中完成，追加到上次剩余不足一个窗口的样本之后
+        size_t pendingSamples = captureBuffer.size();
+        captureBuffer.resize(pendingSamples + numSamples);
+        wenet::ConvertPcm16(samples, numSamples, samplingAmplificationFactor, captureBuffer.data() + pendingSamples);
+
+        size_t offset = 0;
+        for (; offset + windowSamples <= captureBuffer.size(); offset += windowSamples)
+        {
+            const float *window = captureBuffer.data() + offset;
+            // 缓冲保持int16刻度供特征提取，VAD输入时归一化
             vad->predict(
-                inputData, [](int startTime)
+                window, 1.0f / 32768, [this](int startTime)
                 {
-                    samplingData.clear();
                     isSampling = true;
                     samplingStartTime = startTime; },
-                [](int endTime)
+                [this](int endTime)
                 {
-                    decodeQueue.push({samplingData, samplingStartTime, endTime});
-                    cv.notify_one();
-                    samplingData.clear();
+                    pushSampledData(nullptr, 0, samplingStartTime, endTime, true);
                     isSampling = false;
                 });
             if (isSampling)
             {
-                samplingData.insert(samplingData.end(), inputData.begin(), inputData.end());
-                int currentSamplingDuration = vad->getCurrentTime() - samplingStartTime;
-                if (currentSamplingDuration >= vadMaxSamplingDuration)
+                int64_t currentTime = vad->getCurrentTime();
+                pushSampledData(window, windowSamples, samplingStartTime, currentTime, false);
+                if (currentTime - samplingStartTime >= vadMaxSamplingDuration)
                 {
-                    decodeQueue.push({samplingData, samplingStartTime, samplingStartTime + currentSamplingDuration});
-                    samplingStartTime = samplingStartTime + currentSamplingDuration;
-                    cv.notify_one();
-                    samplingData.clear();
+                    pushSampledData(nullptr, 0, samplingStartTime, currentTime, true);
+                    samplingStartTime = currentTime;
                 }
             }
         }
+        captureBuffer.erase(captureBuffer.begin(), captureBuffer.begin() + offset);
     }
 
-    void output(const std::function<void(const DecodeResult&)>& _callback)
+    // 发布合并的溢出采样块，槽位缓冲与溢出缓冲交换而非复制
+    bool ListenerSession::flushOverflow()
+    {
+        if (!overflowPending)
+        {
+            return true;
+        }
+        SampledData *slot = decodeQueue->Back();
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        std::swap(slot->data, overflowData.data);
+        slot->startTime = overflowData.startTime;
+        slot->endTime = overflowData.endTime;
+        slot->final = overflowData.final;
+        decodeQueue->Push();
+        overflowPending = false;
+        return true;
+    }
+
+    // 采样块送入解码队列（仅采集线程调用，不加锁不阻塞）：
+    // 队列已满时合并到溢出缓冲，溢出缓冲已是完整语音段时丢弃新语音段
+    void ListenerSession::pushSampledData(const float *data, size_t size, int64_t startTime, int64_t endTime, bool final)
+    {
+        if (startTime == droppedSegmentStartTime)
+        {
+            droppedWindows += size == 0 ? 0 : 1;
+            return;
+        }
+        SampledData *slot = flushOverflow() ? decodeQueue->Back() : nullptr;
+        if (slot != nullptr)
+        {
+            slot->data.assign(data, data + size);
+            slot->startTime = startTime;
+            slot->endTime = endTime;
+            slot->final = final;
+            decodeQueue->Push();
+        }
+        else if (!overflowPending)
+        {
+            overflowData.data.assign(data, data + size);
+            overflowData.startTime = startTime;
+            overflowData.endTime = endTime;
+            overflowData.final = final;
+            overflowPending = true;
+            mergedWindows += size == 0 ? 0 : 1;
+        }
+        else if (overflowData.startTime == startTime && !overflowData.final)
+        {
+            overflowData.data.insert(overflowData.data.end(), data, data + size);
+            overflowData.endTime = endTime;
+            overflowData.final = final;
+            mergedWindows += size == 0 ? 0 : 1;
+        }
+        else
+        {
+            droppedSegmentStartTime = startTime;
+            droppedWindows += size == 0 ? 0 : 1;
+            return;
+        }
+        size_t depth = decodeQueue->Size();
+        if (depth > maxQueueDepth.load(std::memory_order_relaxed))
+        {
+            maxQueueDepth.store(depth, std::memory_order_relaxed);
+        }
+        schedule();
+    }
+
+    QueueStats ListenerSession::getQueueStats()
+    {
+        return { decodeQueue->Size(), decodeQueue->Capacity(), maxQueueDepth.load(), mergedWindows.load(), droppedWindows.load() };
+    }
+
+    void ListenerSession::output(const std::function<void(const DecodeResult&)>& _callback)
     {
         callback = _callback;
     }
 
-    void processDecode()
+    void ListenerSession::partialOutput(const std::function<void(const DecodeResult&)>& _callback)
     {
-        while (true)
+        partialCallback = _callback;
+    }
+
+    // 会话未在待解码队列中时加入，保证同一会话同一时刻只有一个工作线程消费其采样块
+    void ListenerSession::schedule()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!scheduled.exchange(true))
         {
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, []
-                    { return !decodeQueue.empty(); });
-            SampledData sampledData = decodeQueue.front();
-            decodeQueue.pop();
+            readySessions.Push(shared_from_this());
+        }
+    }
 
-            for (int i = 0; i < sampledData.data.size(); i++)
+    // 每次调度只处理当前已入队的采样块，各会话轮流占用工作线程
+    void ListenerSession::decode()
+    {
+        size_t count = decodeQueue->Size();
+        for (size_t i = 0; i < count; i++)
+        {
+            SampledData *sampledData = decodeQueue->Front();
+            if (sampledData == nullptr)
             {
-                sampledData.data[i] = sampledData.data[i] * 32768;
+                break;
             }
+            decodeSampledData(*sampledData);
+        }
+        scheduled.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (decodeQueue->Front() != nullptr)
+        {
+            schedule();
+        }
+    }
 
+    // 语音段的采样块到达即提取特征并按块推理编码器与CTC搜索，
+    // 语音结束时仅解码剩余不足一块的特征并做注意力重打分
+    void ListenerSession::decodeSampledData(SampledData &sampledData)
+    {
+        int64_t startTime = sampledData.startTime;
+        int64_t endTime = sampledData.endTime;
+        bool final = sampledData.final;
+
+        if (!segmentActive)
+        {
             decoder->Reset();
-            featurePipeline->Reset();
-            featurePipeline->AcceptWaveform(sampledData.data.data(), sampledData.data.size());
+            segmentActive = true;
+            segmentDecodeDuration = 0;
+            partialResult.clear();
+        }
+        // 槽位数据已是int16刻度，直接送入特征提取后归还槽位
+        const std::vector<float> &data = sampledData.data;
+        if (!data.empty())
+        {
+            featurePipeline->AcceptWaveform(data.data(), data.size());
+        }
+        decodeQueue->Pop();
+        if (final)
+        {
             featurePipeline->set_input_finished();
+        }
 
-            int decodeDuration = 0;
-            std::string finalResult;
-            while (true)
+        // 特征足够一块时推理，不足时等待后续采样块（语音结束后解码剩余特征）
+        wenet::DecodeState state = wenet::DecodeState::kEndBatch;
+        while (true)
+        {
+            wenet::Timer timer;
+            state = decoder->Decode(false);
+            if (state == wenet::DecodeState::kEndFeats)
             {
-                wenet::Timer timer;
-                wenet::DecodeState state = decoder->Decode();
-                if (state == wenet::DecodeState::kEndFeats)
-                {
-                    decoder->Rescoring();
-                }
-                int chunk_decode_time = timer.Elapsed();
-                decodeDuration += chunk_decode_time;
-                if (state == wenet::DecodeState::kEndFeats)
-                {
-                    break;
-                }
+                decoder->Rescoring();
             }
-            if (decoder->DecodedSomething())
+            if (state != wenet::DecodeState::kWaitFeats)
             {
-                finalResult.append(decoder->result()[0].sentence);
+                segmentDecodeDuration += timer.Elapsed();
             }
-            if (finalResult.empty())
+            if (state == wenet::DecodeState::kEndFeats || state == wenet::DecodeState::kWaitFeats)
             {
-                continue;
+                break;
             }
-
-            int audioDuration = sampledData.endTime - sampledData.startTime;
-
-            if(callback)
+            if (partialCallback && decoder->DecodedSomething() && decoder->result()[0].sentence != partialResult)
             {
-                float realTimeFactor = round((static_cast<float>(decodeDuration) / audioDuration) * 1000.0) / 1000.0;
-                callback({ sampledData.startTime, sampledData.endTime, finalResult, decodeDuration, audioDuration, realTimeFactor });
+                partialResult = decoder->result()[0].sentence;
+                int audioDuration = endTime - startTime;
+                float realTimeFactor = audioDuration > 0 ? round((static_cast<float>(segmentDecodeDuration) / audioDuration) * 1000.0) / 1000.0 : 0;
+                partialCallback({ startTime, endTime, partialResult, segmentDecodeDuration, audioDuration, realTimeFactor });
             }
+        }
+        if (state != wenet::DecodeState::kEndFeats)
+        {
+            return;
+        }
+        segmentActive = false;
 
-            lock.unlock();
+        std::string finalResult;
+        if (decoder->DecodedSomething())
+        {
+            finalResult.append(decoder->result()[0].sentence);
+        }
+        if (finalResult.empty())
+        {
+            return;
+        }
+
+        int audioDuration = endTime - startTime;
+
+        if(callback)
+        {
+            float realTimeFactor = round((static_cast<float>(segmentDecodeDuration) / audioDuration) * 1000.0) / 1000.0;
+            callback({ startTime, endTime, finalResult, segmentDecodeDuration, audioDuration, realTimeFactor });
+        }
+    }
+
+    // 解码工作线程：依次取出有待解码采样块的会话并解码，各线程绑定到不同的推理核心
+    void processDecode(int workerIndex)
+    {
+        if (!placement.inference_cpus.empty())
+        {
+            wenet::SetCurrentThreadAffinity({placement.inference_cpus[workerIndex % placement.inference_cpus.size()]});
+        }
+        while (true)
+        {
+            std::shared_ptr<ListenerSession> session = readySessions.Pop();
+            session->decode();
         }
     }
 
-}
\ No newline at end of file
+}
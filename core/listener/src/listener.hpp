@@ -1,14 +1,26 @@
 #ifndef LISTENER_H_
 #define LISTENER_H_
 
+#include <atomic>
 #include <fstream>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <onnxruntime_cxx_api.h>
 
+class VadIterator;
+
+namespace wenet
+{
+    class FeaturePipeline;
+    class AsrDecoder;
+    template <typename T>
+    class SpscQueue;
+}
+
 namespace listener
 {
 
@@ -21,23 +33,116 @@ namespace listener
         float realTimeFactor;
     };
 
+    // 语音段的一块采样：VAD检测到语音后逐窗口送入解码线程，边说边解码
     struct SampledData {
-        std::vector<float> data;
-        int64_t startTime;
-        int64_t endTime;
+        std::vector<float> data;  // 放大后的采样（int16刻度）
+        int64_t startTime;   // 所属语音段开始时间
+        int64_t endTime;     // 当前块结束时间
+        bool final = false;  // 是否为语音段的最后一块（语音结束或达到最长采样时长）
+    };
+
+    // 采集线程到解码线程的队列统计
+    struct QueueStats {
+        size_t depth;           // 当前队列深度
+        size_t capacity;        // 队列容量
+        size_t maxDepth;        // 最大队列深度
+        uint64_t mergedWindows; // 队列已满时合并发布的窗口数
+        uint64_t droppedWindows;// 溢出丢弃的窗口数
+    };
+
+    // 监听会话：一路音频流（麦克风或远程客户端）独占VAD状态、特征流水线与解码器，
+    // 模型与解码资源由所有会话共享；采样块经会话的无锁队列交由解码工作线程池处理，
+    // 同一会话同一时刻只在一个工作线程上解码。同一会话的input需串行调用
+    class ListenerSession : public std::enable_shared_from_this<ListenerSession>
+    {
+    public:
+        ListenerSession();
+        ~ListenerSession();
+
+        // 输入int16采样（任意长度，不足一个VAD窗口的样本保留到下次输入）
+        void input(const int16_t *samples, size_t numSamples);
+
+        void output(const std::function<void(const DecodeResult&)>& callback);
+
+        // 中间结果回调：语音段解码过程中每个块的CTC搜索结果变化时调用
+        void partialOutput(const std::function<void(const DecodeResult&)>& callback);
+
+        // 获取采集到解码的队列统计
+        QueueStats getQueueStats();
+
+        // 解码工作线程调用：处理已入队的采样块，仍有采样块时重新调度
+        void decode();
+
+    private:
+        bool flushOverflow();
+        void pushSampledData(const float *data, size_t size, int64_t startTime, int64_t endTime, bool final);
+        void decodeSampledData(SampledData &sampledData);
+        void schedule();
+
+        std::unique_ptr<VadIterator> vad;
+        std::shared_ptr<wenet::FeaturePipeline> featurePipeline;
+        std::unique_ptr<wenet::AsrDecoder> decoder;
+        std::unique_ptr<wenet::SpscQueue<SampledData>> decodeQueue; // 采集线程到解码工作线程的有界无锁队列，槽位缓冲复用
+        std::atomic<bool> scheduled{false};                         // 是否已在工作线程池的待解码队列中或正在解码
+        std::function<void(const DecodeResult&)> callback;
+        std::function<void(const DecodeResult&)> partialCallback;
+
+        // 采集线程独占
+        std::vector<float> captureBuffer;  // 已转换未满一个VAD窗口的样本（int16刻度，复用容量）
+        SampledData overflowData;          // 队列已满时合并待发布的采样块
+        bool overflowPending = false;
+        int64_t droppedSegmentStartTime = -1; // 正在丢弃的语音段开始时间
+        int64_t samplingStartTime = 0;
+        bool isSampling = false;
+        std::atomic<size_t> maxQueueDepth{0};
+        std::atomic<uint64_t> mergedWindows{0};
+        std::atomic<uint64_t> droppedWindows{0};
+
+        // 解码工作线程独占
+        bool segmentActive = false;     // 是否正在解码语音段
+        int segmentDecodeDuration = 0;  // 当前语音段累计解码耗时
+        std::string partialResult;      // 当前语音段最近一次中间结果
     };
 
     // 获取版本
     std::string getVersion();
 
-    void init(int sampleRate, int vadWindowFrameSize, double vadThreshold, int vadMaxSamplingDuration, float samplingAmplificationFactor, int16_t chunkSize, int16_t numThreads);
+    void init(int sampleRate, int vadWindowFrameSize, double vadThreshold, int vadMaxSamplingDuration, float samplingAmplificationFactor, int16_t chunkSize, int16_t numThreads, int decodeQueueCapacity);
+
+    // 按CPU拓扑规划线程放置（推理线程所在簇：auto / big / little / none），需在loadModels前调用，返回放置描述
+    std::string configurePlacement(const std::string &inferenceCluster, bool pinAudio);
+
+    // 配置优化模型缓存目录（为空不缓存）与模型预热，需在loadModels前调用
+    void configureModelCache(const std::string &cacheDirPath, bool warmup);
 
+    // 配置解码工作线程数（所有会话共享），需在loadModels前调用
+    void configureDecodeWorkers(int numWorkers);
+
+    // 配置跨会话VAD批推理：批上限（1为不批处理）与凑批等待时间（毫秒），需在loadModels前调用
+    void configureVadBatching(int maxBatchSize, int maxDelayMs);
+
+    // 加载模型并启动解码工作线程池，同时创建默认会话（供以下全局input/output接口使用）
     void loadModels(const std::string &modelDirPath, const std::string &unitPath);
 
+    // 创建共享已加载模型的监听会话，需在loadModels后调用
+    std::shared_ptr<ListenerSession> createSession();
+
+    // 输入小端int16 PCM字节（默认会话）
     void input(const std::string &raw);
 
+    // 输入int16采样（默认会话）
+    void input(const int16_t *samples, size_t numSamples);
+
+    // 将调用线程绑定到音频专用核心，仅应由监听器自有的采集线程（同时执行VAD）调用；未规划音频核心或绑定失败时返回false
+    bool pinCaptureThread();
+
+    // 获取默认会话的队列统计
+    QueueStats getQueueStats();
+
     void output(const std::function<void(const DecodeResult&)>& callback);
 
+    void partialOutput(const std::function<void(const DecodeResult&)>& callback);
+
 }
 
 #endif
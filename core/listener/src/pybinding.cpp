@@ -21,10 +21,58 @@ PYBIND11_MODULE(listener, m)
         .def_readwrite("audio_duration", &listener::DecodeResult::audioDuration)
         .def_readwrite("rtf", &listener::DecodeResult::realTimeFactor);
 
+    py::class_<listener::QueueStats>(m, "QueueStats")
+        .def(py::init<>())
+        .def_readwrite("depth", &listener::QueueStats::depth)
+        .def_readwrite("capacity", &listener::QueueStats::capacity)
+        .def_readwrite("max_depth", &listener::QueueStats::maxDepth)
+        .def_readwrite("merged_windows", &listener::QueueStats::mergedWindows)
+        .def_readwrite("dropped_windows", &listener::QueueStats::droppedWindows);
+
+    // 各路音频流独立的监听会话，共享已加载的模型与解码工作线程池
+    py::class_<listener::ListenerSession, std::shared_ptr<listener::ListenerSession>>(m, "ListenerSession")
+        .def("input", [](listener::ListenerSession &session, py::bytes raw) {
+            char *buffer = nullptr;
+            Py_ssize_t length = 0;
+            PyBytes_AsStringAndSize(raw.ptr(), &buffer, &length);
+            py::gil_scoped_release release;
+            session.input(reinterpret_cast<const int16_t *>(buffer), static_cast<size_t>(length) / 2);
+        }, "input pcm data")
+        .def("input", [](listener::ListenerSession &session, py::array_t<int16_t, py::array::c_style> samples) {
+            const int16_t *data = samples.data();
+            size_t size = static_cast<size_t>(samples.size());
+            py::gil_scoped_release release;
+            session.input(data, size);
+        }, "input int16 samples")
+        .def("get_queue_stats", &listener::ListenerSession::getQueueStats, "get capture to decode queue stats")
+        .def("output", &listener::ListenerSession::output, "output decode result")
+        .def("partial_output", &listener::ListenerSession::partialOutput, "output partial decode result");
+
     m.def("get_version", &listener::getVersion, "get listener version");
     m.def("init", &listener::init, "init listener");
+    m.def("configure_placement", &listener::configurePlacement, "plan thread placement by cpu topology");
+    m.def("configure_model_cache", &listener::configureModelCache, "configure optimized model cache and warm-up");
+    m.def("configure_decode_workers", &listener::configureDecodeWorkers, "configure decode worker threads shared by sessions");
+    m.def("configure_vad_batching", &listener::configureVadBatching, "configure cross-session vad batch inference");
     m.def("load_models", &listener::loadModels, "load onnx models");
-    m.def("input", &listener::input, "input pcm data");
+    m.def("create_session", &listener::createSession, "create listener session sharing loaded models");
+    // PyAudio回调的bytes与int16 numpy数组均原地读取，不复制到std::string；VAD期间释放GIL
+    m.def("input", [](py::bytes raw) {
+        char *buffer = nullptr;
+        Py_ssize_t length = 0;
+        PyBytes_AsStringAndSize(raw.ptr(), &buffer, &length);
+        py::gil_scoped_release release;
+        listener::input(reinterpret_cast<const int16_t *>(buffer), static_cast<size_t>(length) / 2);
+    }, "input pcm data");
+    m.def("input", [](py::array_t<int16_t, py::array::c_style> samples) {
+        const int16_t *data = samples.data();
+        size_t size = static_cast<size_t>(samples.size());
+        py::gil_scoped_release release;
+        listener::input(data, size);
+    }, "input int16 samples");
+    m.def("pin_capture_thread", &listener::pinCaptureThread, "pin the calling capture thread to the audio cores");
+    m.def("get_queue_stats", &listener::getQueueStats, "get capture to decode queue stats");
     m.def("output", &listener::output, "output decode result");
+    m.def("partial_output", &listener::partialOutput, "output partial decode result");
 
 }
@@ -0,0 +1,158 @@
+#include "utils/cpu_topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace wenet {
+
+namespace {
+
+bool ReadNumber(const std::string& path, uint32_t* value) {
+  std::ifstream file(path);
+  return static_cast<bool>(file >> *value);
+}
+
+// Parse lists like "0-3,5,7-8".
+std::vector<int> ParseCpuList(const std::string& text) {
+  std::vector<int> cpus;
+  std::stringstream stream(text);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    size_t dash = range.find('-');
+    try {
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first
+                                           : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } catch (const std::exception&) {
+      continue;
+    }
+  }
+  return cpus;
+}
+
+std::string FormatCpuList(const std::vector<int>& cpus) {
+  std::string text;
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    if (!text.empty()) text += ",";
+    text += std::to_string(cpus[i]);
+    if (j > i) text += "-" + std::to_string(cpus[j]);
+    i = j;
+  }
+  return text;
+}
+
+}  // namespace
+
+std::vector<CpuCluster> ReadCpuClusters(const std::string& sysfs_root) {
+  std::ifstream online_file(sysfs_root + "/online");
+  std::string online;
+  if (!std::getline(online_file, online)) {
+    return {};
+  }
+  std::map<uint32_t, std::vector<int>, std::greater<uint32_t>> groups;
+  for (int cpu : ParseCpuList(online)) {
+    std::string cpu_root = sysfs_root + "/cpu" + std::to_string(cpu);
+    uint32_t capacity = 0;
+    if (!ReadNumber(cpu_root + "/cpu_capacity", &capacity)) {
+      ReadNumber(cpu_root + "/cpufreq/cpuinfo_max_freq", &capacity);
+    }
+    groups[capacity].push_back(cpu);
+  }
+  std::vector<CpuCluster> clusters;
+  for (auto& group : groups) {
+    CpuCluster cluster;
+    cluster.capacity = group.first;
+    cluster.cpus = std::move(group.second);
+    clusters.push_back(std::move(cluster));
+  }
+  return clusters;
+}
+
+ThreadPlacement PlanThreadPlacement(const std::vector<CpuCluster>& clusters,
+                                    int num_threads,
+                                    const PlacementOptions& options) {
+  ThreadPlacement placement;
+  placement.clusters = clusters;
+  const std::string& policy = options.inference_cluster;
+  // Homogeneous CPUs are left to the scheduler in auto mode.
+  if (policy == "none" || clusters.empty() ||
+      (policy == "auto" && clusters.size() < 2)) {
+    return placement;
+  }
+  std::vector<CpuCluster> ordered = clusters;
+  if (policy == "little") {
+    std::reverse(ordered.begin(), ordered.end());
+  }
+  std::vector<int> candidates;
+  for (const auto& cluster : ordered) {
+    candidates.insert(candidates.end(), cluster.cpus.begin(),
+                      cluster.cpus.end());
+  }
+  // The audio thread takes the last core of the last cluster so it never
+  // competes with inference.
+  if (options.pin_audio && candidates.size() > 1) {
+    placement.audio_cpus.push_back(candidates.back());
+    candidates.pop_back();
+  }
+  size_t count =
+      num_threads > 0 ? num_threads : ordered.front().cpus.size();
+  count = std::min(count, candidates.size());
+  placement.inference_cpus.assign(candidates.begin(),
+                                  candidates.begin() + count);
+  return placement;
+}
+
+std::string ThreadPlacement::Describe() const {
+  std::string text = "clusters=";
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    if (i > 0) text += ",";
+    text += "[" + FormatCpuList(clusters[i].cpus) + "]@" +
+            std::to_string(clusters[i].capacity);
+  }
+  text += " inference=" + (inference_cpus.empty()
+                               ? std::string("unpinned")
+                               : FormatCpuList(inference_cpus));
+  text += " audio=" + (audio_cpus.empty() ? std::string("unpinned")
+                                          : FormatCpuList(audio_cpus));
+  return text;
+}
+
+std::string FormatIntraOpAffinities(const std::vector<int>& cpus) {
+  std::string text;
+  for (size_t i = 1; i < cpus.size(); ++i) {
+    if (i > 1) text += ";";
+    text += std::to_string(cpus[i] + 1);
+  }
+  return text;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+  if (cpus.empty()) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace wenet
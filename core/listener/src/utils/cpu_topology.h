@@ -0,0 +1,54 @@
+#ifndef UTILS_CPU_TOPOLOGY_H_
+#define UTILS_CPU_TOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wenet {
+
+// A group of cores with the same capacity, e.g. the A76 or A55 cluster of
+// an RK3588.
+struct CpuCluster {
+  // cpu_capacity from sysfs, or cpuinfo_max_freq (kHz) when missing
+  uint32_t capacity = 0;
+  std::vector<int> cpus;
+};
+
+struct PlacementOptions {
+  // auto (big cluster on big.LITTLE, unpinned otherwise), big, little, none
+  std::string inference_cluster = "auto";
+  // Reserve a dedicated core for the real-time audio thread
+  bool pin_audio = true;
+};
+
+struct ThreadPlacement {
+  // Clusters sorted by capacity, highest first
+  std::vector<CpuCluster> clusters;
+  // One core per intra-op thread, empty means unpinned
+  std::vector<int> inference_cpus;
+  std::vector<int> audio_cpus;
+
+  // e.g. "clusters=[4-7]@1024,[0-3]@414 inference=4,5 audio=3"
+  std::string Describe() const;
+};
+
+// Read online cores from sysfs and group them by capacity.
+std::vector<CpuCluster> ReadCpuClusters(
+    const std::string& sysfs_root = "/sys/devices/system/cpu");
+
+ThreadPlacement PlanThreadPlacement(const std::vector<CpuCluster>& clusters,
+                                    int num_threads,
+                                    const PlacementOptions& options);
+
+// Value of onnxruntime's "session.intra_op_thread_affinities". The thread
+// calling Run() is the first intra-op thread and is not listed; processor
+// ids are 1-based.
+std::string FormatIntraOpAffinities(const std::vector<int>& cpus);
+
+// Pin the calling thread, returns false on failure or empty cpus.
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
+}  // namespace wenet
+
+#endif  // UTILS_CPU_TOPOLOGY_H_
@@ -0,0 +1,146 @@
+#include "utils/onnx_model_cache.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <direct.h>
+#endif
+
+#include "utils/file.h"
+#include "utils/log.h"
+#ifdef _MSC_VER
+#include "utils/string.h"
+#endif
+
+namespace wenet {
+
+namespace {
+
+#if defined(__aarch64__)
+const char kCpuArch[] = "aarch64";
+#elif defined(__arm__)
+const char kCpuArch[] = "arm";
+#elif defined(__x86_64__) || defined(_M_X64)
+const char kCpuArch[] = "x86_64";
+#else
+const char kCpuArch[] = "unknown";
+#endif
+
+// FNV-1a over 8-byte words, fast enough to hash a model on every boot.
+uint64_t HashFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file.good()) << "model file open failed: " << path;
+  uint64_t hash = 14695981039346656037ULL;
+  std::vector<char> buffer(1 << 20);
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    size_t size = static_cast<size_t>(file.gcount());
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+      uint64_t word;
+      memcpy(&word, buffer.data() + offset, 8);
+      hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (; offset < size; ++offset) {
+      hash = (hash ^ static_cast<uint8_t>(buffer[offset])) * 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+std::string BaseName(const std::string& path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.rfind('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+void MakeDirs(const std::string& dir) {
+  for (size_t pos = dir.find('/', 1); ; pos = dir.find('/', pos + 1)) {
+    std::string prefix = dir.substr(0, pos);
+#ifdef _MSC_VER
+    _mkdir(prefix.c_str());
+#else
+    mkdir(prefix.c_str(), 0755);
+#endif
+    if (pos == std::string::npos) {
+      break;
+    }
+  }
+}
+
+std::shared_ptr<Ort::Session> NewSession(Ort::Env& env,
+                                         const std::string& model_path,
+                                         const Ort::SessionOptions& options) {
+#ifdef _MSC_VER
+  return std::make_shared<Ort::Session>(env, ToWString(model_path).c_str(),
+                                        options);
+#else
+  return std::make_shared<Ort::Session>(env, model_path.c_str(), options);
+#endif
+}
+
+}  // namespace
+
+std::string OptimizedModelCacheKey(const std::string& model_path) {
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << HashFile(model_path)
+      << "-ort" << OrtGetApiBase()->GetVersionString() << "-" << kCpuArch;
+  return key.str();
+}
+
+std::shared_ptr<Ort::Session> CreateCachedSession(
+    Ort::Env& env, const std::string& model_path,
+    const Ort::SessionOptions& options, const std::string& cache_dir) {
+  if (cache_dir.empty()) {
+    return NewSession(env, model_path, options);
+  }
+  std::string cache_path = cache_dir + "/" + BaseName(model_path) + "-" +
+                           OptimizedModelCacheKey(model_path) + ".onnx";
+  if (FileExists(cache_path)) {
+    // The cached graph is fully optimized already
+    Ort::SessionOptions cached_options = options.Clone();
+    cached_options.SetGraphOptimizationLevel(
+        GraphOptimizationLevel::ORT_DISABLE_ALL);
+    try {
+      auto session = NewSession(env, cache_path, cached_options);
+      LOG(INFO) << "Optimized model cache hit: " << cache_path;
+      return session;
+    } catch (const Ort::Exception& e) {
+      LOG(WARNING) << "Optimized model cache invalid, rebuilding: "
+                   << e.what();
+      std::remove(cache_path.c_str());
+    }
+  }
+  MakeDirs(cache_dir);
+  // Write to a temporary file and rename, so that concurrently starting
+  // processes never load a partial model.
+  std::string temp_path =
+      cache_path + ".tmp" + std::to_string(std::random_device()());
+  Ort::SessionOptions optimize_options = options.Clone();
+#ifdef _MSC_VER
+  optimize_options.SetOptimizedModelFilePath(ToWString(temp_path).c_str());
+#else
+  optimize_options.SetOptimizedModelFilePath(temp_path.c_str());
+#endif
+  auto session = NewSession(env, model_path, optimize_options);
+  if (std::rename(temp_path.c_str(), cache_path.c_str()) != 0) {
+    LOG(WARNING) << "Optimized model cache write failed: " << cache_path
+                 << " " << strerror(errno);
+    std::remove(temp_path.c_str());
+  } else {
+    LOG(INFO) << "Optimized model cached: " << cache_path;
+  }
+  return session;
+}
+
+}  // namespace wenet
@@ -0,0 +1,26 @@
+#ifndef UTILS_ONNX_MODEL_CACHE_H_
+#define UTILS_ONNX_MODEL_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace wenet {
+
+// Cache key of an optimized model: content hash of the source model, ORT
+// version and cpu arch (ORT_ENABLE_ALL layout transforms are hardware
+// specific).
+std::string OptimizedModelCacheKey(const std::string& model_path);
+
+// Creates a session for model_path. With a non-empty cache_dir the optimized
+// graph is loaded from the cache without re-running graph optimization; on a
+// miss the model is optimized as configured in options and the result is
+// written to the cache for later boots.
+std::shared_ptr<Ort::Session> CreateCachedSession(
+    Ort::Env& env, const std::string& model_path,
+    const Ort::SessionOptions& options, const std::string& cache_dir);
+
+}  // namespace wenet
+
+#endif  // UTILS_ONNX_MODEL_CACHE_H_
@@ -0,0 +1,79 @@
+#ifndef UTILS_SPSC_QUEUE_H_
+#define UTILS_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "utils/utils.h"
+
+namespace wenet {
+
+// Bounded lock-free single-producer single-consumer ring. Slots are
+// allocated once and reused as a pool: the producer fills the slot returned
+// by Back() in place and publishes it with Push(), the consumer reads Front()
+// in place and recycles it with Pop(). Elements are never copied by the
+// queue, and buffers inside a slot keep their capacity across reuses.
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t capacity) : slots_(capacity + 1) {}
+
+  // Producer side. Returns nullptr when the queue is full.
+  T* Back() {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (Next(tail) == head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots_[tail];
+  }
+
+  // Publish the slot returned by Back().
+  void Push() {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(Next(tail), std::memory_order_release);
+  }
+
+  // Consumer side. Returns nullptr when the queue is empty.
+  T* Front() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &slots_[head];
+  }
+
+  // Recycle the slot returned by Front().
+  void Pop() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    head_.store(Next(head), std::memory_order_release);
+  }
+
+  // Approximate when called concurrently with Push() or Pop().
+  size_t Size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : tail + slots_.size() - head;
+  }
+
+  size_t Capacity() const { return slots_.size() - 1; }
+
+ private:
+  size_t Next(size_t index) const {
+    return index + 1 == slots_.size() ? 0 : index + 1;
+  }
+
+  // Keep producer and consumer indices on separate cache lines. Padding
+  // instead of alignas, which C++14 operator new does not honour.
+  std::atomic<size_t> head_{0};
+  char padding_[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> tail_{0};
+  std::vector<T> slots_;
+
+ public:
+  WENET_DISALLOW_COPY_AND_ASSIGN(SpscQueue);
+};
+
+}  // namespace wenet
+
+#endif  // UTILS_SPSC_QUEUE_H_
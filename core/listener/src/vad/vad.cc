@@ -6,7 +6,9 @@
 #include <chrono>
 #include <cmath>
 
+#include "utils/onnx_model_cache.h"
 #include "vad.h"
+#include "vad_batcher.h"
 
 VadIterator::VadIterator(int sampleRate, int frameSize, float _threshold, int minSilenceDurationMS, int speechPadMS)
 {
@@ -27,7 +29,15 @@ VadIterator::VadIterator(int sampleRate, int frameSize, float _threshold, int mi
     sr[0] = sample_rate;
 }
 
-void VadIterator::loadModel(const std::string &model_path, int inter_threads, int intra_threads)
+VadIterator::~VadIterator()
+{
+    if (batcher)
+    {
+        batcher->removeStream(*this);
+    }
+}
+
+void VadIterator::loadModel(const std::string &model_path, int inter_threads, int intra_threads, const std::string &optimized_model_cache_dir)
 {   
     session_options.SetIntraOpNumThreads(intra_threads);
     session_options.SetInterOpNumThreads(inter_threads);
@@ -37,7 +47,28 @@ void VadIterator::loadModel(const std::string &model_path, int inter_threads, in
     session_options.DisableProfiling();
     session_options.SetLogSeverityLevel(3);
     // Load model
-    session = std::make_shared<Ort::Session>(env, model_path.c_str(), session_options);
+    session = wenet::CreateCachedSession(env, model_path, session_options, optimized_model_cache_dir);
+}
+
+void VadIterator::shareModel(const VadIterator &other)
+{
+    session = other.session;
+}
+
+void VadIterator::setBatcher(const std::shared_ptr<VadBatcher> &_batcher)
+{
+    if (batcher)
+    {
+        batcher->removeStream(*this);
+    }
+    batcher = _batcher;
+}
+
+void VadIterator::warmUp()
+{
+    std::vector<float> silence(window_size_samples, 0.0f);
+    predict(silence, [](int) {}, [](int) {});
+    resetStates();
 }
 
 int VadIterator::getCurrentTime()
@@ -55,12 +86,10 @@ void VadIterator::resetStates()
     current_sample = 0;
 }
 
-void VadIterator::predict(const std::vector<float> &data, const std::function<void(int)>& startCallback, const std::function<void(int)>& endCallback)
+// 单流推理：以batch=1运行模型并更新h/c状态
+float VadIterator::infer()
 {
-   
-    // Infer
     // Create ort tensors
-    input.assign(data.begin(), data.end());
     Ort::Value input_ort = Ort::Value::CreateTensor<float>(
         memory_info, input.data(), input.size(), input_node_dims, 2);
     Ort::Value sr_ort = Ort::Value::CreateTensor<int64_t>(
@@ -89,6 +118,22 @@ void VadIterator::predict(const std::vector<float> &data, const std::function<vo
     std::memcpy(_h.data(), hn, size_hc * sizeof(float));
     float *cn = ort_outputs[2].GetTensorMutableData<float>();
     std::memcpy(_c.data(), cn, size_hc * sizeof(float));
+    return output;
+}
+
+void VadIterator::predict(const std::vector<float> &data, const std::function<void(int)>& startCallback, const std::function<void(int)>& endCallback)
+{
+    predict(data.data(), 1.0f, startCallback, endCallback);
+}
+
+void VadIterator::predict(const float *data, float scale, const std::function<void(int)>& startCallback, const std::function<void(int)>& endCallback)
+{
+    // 复制窗口到模型输入
+    for (int64_t i = 0; i < window_size_samples; i++)
+    {
+        input[i] = data[i] * scale;
+    }
+    float output = batcher ? batcher->infer(*this) : infer();
 
     // Push forward sample index
     current_sample += window_size_samples;
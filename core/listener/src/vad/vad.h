@@ -1,13 +1,18 @@
 #ifndef VAD_VAD_H_
 #define VAD_VAD_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"
 
+class VadBatcher;
+
 class VadIterator
 {
+    friend class VadBatcher;
+
     Ort::Env env;
     Ort::SessionOptions session_options;
     std::shared_ptr<Ort::Session> session = nullptr;
@@ -16,7 +21,17 @@ class VadIterator
 
 public:
 
-    void loadModel(const std::string &model_path, int inter_threads, int intra_threads);
+    // optimized_model_cache_dir: 优化模型缓存目录，为空时每次加载重新执行图优化
+    void loadModel(const std::string &model_path, int inter_threads, int intra_threads, const std::string &optimized_model_cache_dir = "");
+
+    // 共享另一实例已加载的推理会话（ORT会话可并发推理），各实例仅维护自己的检测状态
+    void shareModel(const VadIterator &other);
+
+    // 启用跨流批处理：此后各窗口经batcher与其它流合批推理，首次提交窗口后计入活跃流
+    void setBatcher(const std::shared_ptr<VadBatcher> &batcher);
+
+    // 以一个采样窗口的静音预先推理，首次检测即达到稳态延迟
+    void warmUp();
 
     int getCurrentTime();
 
@@ -24,7 +39,12 @@ public:
 
     void predict(const std::vector<float> &data, const std::function<void(int)>& startCallback, const std::function<void(int)>& endCallback);
 
+    // 读取一个采样窗口（window_size_samples个样本），复制到模型输入时乘以scale
+    void predict(const float *data, float scale, const std::function<void(int)>& startCallback, const std::function<void(int)>& endCallback);
+
 private:
+    float infer();
+
     // model config
     int64_t window_size_samples;  // Assign when init, support 256 512 768 for 8k; 512 1024 1536 for 16k.
     int sample_rate;
@@ -42,6 +62,8 @@ private:
     // MAX 4294967295 samples / 8sample per ms / 1000 / 60 = 8947 minutes  
     float output;
 
+    std::shared_ptr<VadBatcher> batcher = nullptr;
+
     // Onnx model
     // Inputs
     std::vector<Ort::Value> ort_inputs;
@@ -65,6 +87,7 @@ private:
 public:
     // Construction
     VadIterator(int sampleRate, int frameSize, float threshold, int minSilenceDurationMS, int speechPadMS);
+    ~VadIterator();
 
 };
 
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "vad.h"
+#include "vad_batcher.h"
+
+VadBatcher::VadBatcher(int _maxBatchSize, int maxDelayMs)
+    : maxBatchSize(static_cast<size_t>(std::max(_maxBatchSize, 1))),
+      maxDelay(std::max(maxDelayMs, 0))
+{
+}
+
+void VadBatcher::removeStream(const VadIterator &vad)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    lastSubmitTime.erase(&vad);
+    // 活跃流减少后等待中的批可能已凑齐
+    cv.notify_all();
+}
+
+// 统计活跃流数并清除过期记录（调用方持有mutex），按实时速率输入的流每个窗口时长提交一次
+size_t VadBatcher::activeStreams(const VadIterator &vad, std::chrono::steady_clock::time_point now)
+{
+    auto activeWindow = std::chrono::microseconds(2 * vad.window_size_samples * 1000000 / vad.sample_rate);
+    for (auto it = lastSubmitTime.begin(); it != lastSubmitTime.end();)
+    {
+        it = now - it->second > activeWindow ? lastSubmitTime.erase(it) : std::next(it);
+    }
+    return std::max<size_t>(lastSubmitTime.size(), 1);
+}
+
+float VadBatcher::infer(VadIterator &vad)
+{
+    Request request;
+    request.vad = &vad;
+    std::unique_lock<std::mutex> lock(mutex);
+    lastSubmitTime[&vad] = std::chrono::steady_clock::now();
+    pending.push_back(&request);
+    cv.notify_all();
+    while (!request.done)
+    {
+        // 已有领导者或本窗口已在推理中的批内时等待
+        if (leaderActive || !request.queued)
+        {
+            cv.wait(lock, [&]
+                    { return request.done || (!leaderActive && request.queued); });
+            continue;
+        }
+        // 成为领导者：等待批满、凑齐所有活跃流或超时
+        leaderActive = true;
+        auto now = std::chrono::steady_clock::now();
+        size_t target = std::min(maxBatchSize, activeStreams(vad, now));
+        cv.wait_until(lock, now + maxDelay, [&]
+                      { return pending.size() >= std::min(target, std::max<size_t>(lastSubmitTime.size(), 1)); });
+        size_t batchSize = std::min(pending.size(), maxBatchSize);
+        std::vector<Request *> batch(pending.begin(), pending.begin() + batchSize);
+        pending.erase(pending.begin(), pending.begin() + batchSize);
+        for (Request *taken : batch)
+        {
+            taken->queued = false;
+        }
+        leaderActive = false;
+        cv.notify_all();
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            run(batch);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        for (Request *finished : batch)
+        {
+            finished->error = error;
+            finished->done = true;
+        }
+        cv.notify_all();
+    }
+    if (request.error)
+    {
+        std::rethrow_exception(request.error);
+    }
+    return request.output;
+}
+
+void VadBatcher::run(const std::vector<Request *> &batch)
+{
+    std::lock_guard<std::mutex> lock(runMutex);
+    VadIterator &first = *batch.front()->vad;
+    const int64_t batchSize = static_cast<int64_t>(batch.size());
+    const int64_t windowSamples = first.window_size_samples;
+    const size_t stateSize = first.size_hc / 2; // 每层每流的状态长度
+    batchInput.resize(batchSize * windowSamples);
+    batchH.resize(2 * batchSize * stateSize);
+    batchC.resize(2 * batchSize * stateSize);
+
+    // 输入按流拼接为{B, N}，h/c按{2, B, 64}排列
+    for (int64_t b = 0; b < batchSize; b++)
+    {
+        VadIterator &vad = *batch[b]->vad;
+        std::memcpy(batchInput.data() + b * windowSamples, vad.input.data(), windowSamples * sizeof(float));
+        for (int64_t layer = 0; layer < 2; layer++)
+        {
+            size_t offset = (layer * batchSize + b) * stateSize;
+            std::memcpy(batchH.data() + offset, vad._h.data() + layer * stateSize, stateSize * sizeof(float));
+            std::memcpy(batchC.data() + offset, vad._c.data() + layer * stateSize, stateSize * sizeof(float));
+        }
+    }
+
+    const int64_t inputDims[2] = {batchSize, windowSamples};
+    const int64_t stateDims[3] = {2, batchSize, static_cast<int64_t>(stateSize)};
+    std::vector<Ort::Value> inputs;
+    inputs.emplace_back(Ort::Value::CreateTensor<float>(first.memory_info, batchInput.data(), batchInput.size(), inputDims, 2));
+    inputs.emplace_back(Ort::Value::CreateTensor<int64_t>(first.memory_info, first.sr.data(), first.sr.size(), first.sr_node_dims, 1));
+    inputs.emplace_back(Ort::Value::CreateTensor<float>(first.memory_info, batchH.data(), batchH.size(), stateDims, 3));
+    inputs.emplace_back(Ort::Value::CreateTensor<float>(first.memory_info, batchC.data(), batchC.size(), stateDims, 3));
+    std::vector<Ort::Value> outputs = first.session->Run(
+        Ort::RunOptions{nullptr},
+        first.input_node_names.data(), inputs.data(), inputs.size(),
+        first.output_node_names.data(), first.output_node_names.size());
+
+    const float *output = outputs[0].GetTensorData<float>();
+    const float *hn = outputs[1].GetTensorData<float>();
+    const float *cn = outputs[2].GetTensorData<float>();
+    for (int64_t b = 0; b < batchSize; b++)
+    {
+        Request &request = *batch[b];
+        request.output = output[b];
+        for (int64_t layer = 0; layer < 2; layer++)
+        {
+            size_t offset = (layer * batchSize + b) * stateSize;
+            std::memcpy(request.vad->_h.data() + layer * stateSize, hn + offset, stateSize * sizeof(float));
+            std::memcpy(request.vad->_c.data() + layer * stateSize, cn + offset, stateSize * sizeof(float));
+        }
+    }
+}
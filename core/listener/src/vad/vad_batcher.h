@@ -0,0 +1,60 @@
+#ifndef VAD_VAD_BATCHER_H_
+#define VAD_VAD_BATCHER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"
+
+class VadIterator;
+
+// 跨音频流的VAD动态批处理：各流的采集线程提交一个窗口后，首个提交者作为本批领导者，
+// 在时间预算内等待其它流的窗口（已凑齐所有活跃流或达到批上限时立即执行），
+// 活跃流为最近两个窗口时长内提交过窗口的流，未输入音频的会话（如未使用的默认会话）不计入，
+// 将各流输入与h/c状态沿批维拼接后单次推理，再将语音概率与新状态分发回各流
+class VadBatcher
+{
+public:
+    VadBatcher(int maxBatchSize, int maxDelayMs);
+
+    // 推理一个窗口（vad.input为已归一化的窗口），原地更新vad的h/c状态，返回语音概率
+    float infer(VadIterator &vad);
+
+    // 流销毁时移除其活跃记录
+    void removeStream(const VadIterator &vad);
+
+private:
+    struct Request
+    {
+        VadIterator *vad;
+        float output = 0.0f;
+        bool queued = true; // 是否仍在等待被领导者取出
+        bool done = false;
+        std::exception_ptr error; // 本批推理异常，由各流的infer重新抛出
+    };
+
+    void run(const std::vector<Request *> &batch);
+    size_t activeStreams(const VadIterator &vad, std::chrono::steady_clock::time_point now);
+
+    const size_t maxBatchSize;
+    const std::chrono::milliseconds maxDelay;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Request *> pending; // 等待推理的窗口
+    bool leaderActive = false;      // 是否已有领导者在收集本批
+    std::unordered_map<const VadIterator *, std::chrono::steady_clock::time_point> lastSubmitTime; // 各流最近提交窗口的时间
+
+    std::mutex runMutex; // 串行化各批推理，推理期间下一批继续收集
+    std::vector<float> batchInput;
+    std::vector<float> batchH;
+    std::vector<float> batchC;
+};
+
+#endif  //VAD_VAD_BATCHER_H_
@@ -0,0 +1,99 @@
+// 响度级int16转换基准：对比逐样本固定增益转换与StreamingLimiter（无需限幅的块走向量化内核）
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "audio_kernel.hpp"
+#include "loudness.hpp"
+
+// 逐样本乘以固定增益后饱和转换为int16
+static void referenceConvert(const float *audio, int64_t audioSamples, float gain, std::vector<int16_t> &audioBuffer)
+{
+    audioBuffer.reserve(audioSamples);
+    for (int64_t i = 0; i < audioSamples; i++)
+    {
+        int16_t intAudioValue = static_cast<int16_t>(
+            std::clamp(audio[i] * gain,
+                       static_cast<float>(std::numeric_limits<int16_t>::min()),
+                       static_cast<float>(std::numeric_limits<int16_t>::max())));
+
+        audioBuffer.push_back(intAudioValue);
+    }
+}
+
+// 与合成路径一致：每段重新配置限幅器，处理后推出延迟线
+static void limiterConvert(const float *audio, int64_t audioSamples, float gain, std::vector<int16_t> &audioBuffer)
+{
+    static speaker::StreamingLimiter limiter;
+    speaker::LimiterConfig config;
+    config.gain = gain;
+    limiter.configure(config);
+    audioBuffer.resize(audioSamples + limiter.latency());
+    size_t written = limiter.process(audio, audioSamples, audioBuffer.data());
+    written += limiter.flush(audioBuffer.data() + written);
+    audioBuffer.resize(written);
+}
+
+template <typename Fn>
+static double measure(Fn fn, const std::vector<float> &audio, float gain, int iterations)
+{
+    std::vector<int16_t> audioBuffer;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        audioBuffer = std::vector<int16_t>();
+        fn(audio.data(), audio.size(), gain, audioBuffer);
+    }
+    auto duration = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime);
+    return duration.count() / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 5;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+    const uint32_t sampleRate = 16000;
+    const float gain = 32768.0f;
+
+    // 模拟vits输出：标定增益下不越界的浮点波形，长度刻意不对齐向量宽度
+    std::vector<float> audio(static_cast<size_t>(seconds) * sampleRate + 13);
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    for (size_t i = 0; i < audio.size(); i++)
+    {
+        audio[i] = std::clamp(0.5f * std::sin(i * 0.05f) + noise(rng), -0.99f, 0.99f);
+    }
+    // 每秒插入一段越界峰值，触发逐样本限幅
+    std::vector<float> peakAudio = audio;
+    for (size_t i = 0; i < peakAudio.size(); i += sampleRate)
+    {
+        for (size_t j = i; j < std::min(peakAudio.size(), i + 64); j++)
+        {
+            peakAudio[j] *= 2.0f;
+        }
+    }
+
+    std::vector<int16_t> expected, actual;
+    referenceConvert(audio.data(), audio.size(), gain, expected);
+    limiterConvert(audio.data(), audio.size(), gain, actual);
+    if (expected != actual)
+    {
+        std::cerr << "mismatch between reference and " << speaker::audioKernelName() << " limiter" << std::endl;
+        return 1;
+    }
+
+    double referenceTime = measure(referenceConvert, audio, gain, iterations);
+    double limiterTime = measure(limiterConvert, audio, gain, iterations);
+    double peakTime = measure(limiterConvert, peakAudio, gain, iterations);
+    std::cout << "samples: " << audio.size() << " (" << seconds << "s @ " << sampleRate << "Hz)" << std::endl;
+    std::cout << "reference: " << referenceTime << " us" << std::endl;
+    std::cout << speaker::audioKernelName() << " limiter: " << limiterTime << " us" << std::endl;
+    std::cout << "speedup: " << referenceTime / limiterTime << "x" << std::endl;
+    std::cout << speaker::audioKernelName() << " limiter with peaks: " << peakTime << " us" << std::endl;
+    return 0;
+}
@@ -0,0 +1,693 @@
+// 端到端TTS基准：加载vits模型与配置，在多个推理线程数下对语料逐句流式合成，
+// 以JSON输出RTF分位数、首块延迟、吞吐与峰值RSS
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "speaker.hpp"
+
+// 最小JSON解析，仅用于读取模型配置
+struct JsonValue
+{
+    enum Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    } type = Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::map<std::string, JsonValue> object;
+
+    const JsonValue *get(const std::string &key) const
+    {
+        auto it = object.find(key);
+        return it == object.end() ? nullptr : &it->second;
+    }
+};
+
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string &text) : text(text) {}
+
+    JsonValue parse()
+    {
+        JsonValue value = parseValue();
+        skipSpace();
+        if (position != text.size())
+        {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+private:
+    void fail(const std::string &message) const
+    {
+        throw std::runtime_error("invalid json at " + std::to_string(position) + ": " + message);
+    }
+
+    void skipSpace()
+    {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+        {
+            position++;
+        }
+    }
+
+    bool consume(const char *literal)
+    {
+        size_t length = std::char_traits<char>::length(literal);
+        if (text.compare(position, length, literal) != 0)
+        {
+            return false;
+        }
+        position += length;
+        return true;
+    }
+
+    JsonValue parseValue()
+    {
+        skipSpace();
+        if (position >= text.size())
+        {
+            fail("unexpected end");
+        }
+        JsonValue value;
+        char c = text[position];
+        if (c == '{')
+        {
+            value.type = JsonValue::Object;
+            position++;
+            skipSpace();
+            if (position < text.size() && text[position] == '}')
+            {
+                position++;
+                return value;
+            }
+            while (true)
+            {
+                skipSpace();
+                std::string key = parseString();
+                skipSpace();
+                if (!consume(":"))
+                {
+                    fail("expected ':'");
+                }
+                value.object[key] = parseValue();
+                skipSpace();
+                if (consume("}"))
+                {
+                    return value;
+                }
+                if (!consume(","))
+                {
+                    fail("expected ','");
+                }
+            }
+        }
+        if (c == '[')
+        {
+            value.type = JsonValue::Array;
+            position++;
+            skipSpace();
+            if (position < text.size() && text[position] == ']')
+            {
+                position++;
+                return value;
+            }
+            while (true)
+            {
+                value.array.push_back(parseValue());
+                skipSpace();
+                if (consume("]"))
+                {
+                    return value;
+                }
+                if (!consume(","))
+                {
+                    fail("expected ','");
+                }
+            }
+        }
+        if (c == '"')
+        {
+            value.type = JsonValue::String;
+            value.string = parseString();
+            return value;
+        }
+        if (consume("true"))
+        {
+            value.type = JsonValue::Bool;
+            value.boolean = true;
+            return value;
+        }
+        if (consume("false"))
+        {
+            value.type = JsonValue::Bool;
+            return value;
+        }
+        if (consume("null"))
+        {
+            return value;
+        }
+        char *end = nullptr;
+        value.type = JsonValue::Number;
+        value.number = std::strtod(text.c_str() + position, &end);
+        if (end == text.c_str() + position)
+        {
+            fail("unexpected character");
+        }
+        position = end - text.c_str();
+        return value;
+    }
+
+    std::string parseString()
+    {
+        if (!consume("\""))
+        {
+            fail("expected string");
+        }
+        std::string result;
+        while (position < text.size() && text[position] != '"')
+        {
+            char c = text[position++];
+            if (c != '\\')
+            {
+                result += c;
+                continue;
+            }
+            if (position >= text.size())
+            {
+                fail("unexpected end");
+            }
+            char escape = text[position++];
+            switch (escape)
+            {
+            case 'n':
+                result += '\n';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'u':
+                appendCodepoint(parseCodepoint(), result);
+                break;
+            default:
+                result += escape;
+            }
+        }
+        if (!consume("\""))
+        {
+            fail("unterminated string");
+        }
+        return result;
+    }
+
+    uint32_t parseHex()
+    {
+        if (position + 4 > text.size())
+        {
+            fail("invalid unicode escape");
+        }
+        uint32_t value = std::stoul(text.substr(position, 4), nullptr, 16);
+        position += 4;
+        return value;
+    }
+
+    uint32_t parseCodepoint()
+    {
+        uint32_t codepoint = parseHex();
+        // 代理对
+        if (codepoint >= 0xD800 && codepoint <= 0xDBFF && consume("\\u"))
+        {
+            uint32_t low = parseHex();
+            codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        return codepoint;
+    }
+
+    static void appendCodepoint(uint32_t codepoint, std::string &result)
+    {
+        if (codepoint < 0x80)
+        {
+            result += static_cast<char>(codepoint);
+        }
+        else if (codepoint < 0x800)
+        {
+            result += static_cast<char>(0xC0 | (codepoint >> 6));
+            result += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            result += static_cast<char>(0xE0 | (codepoint >> 12));
+            result += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            result += static_cast<char>(0xF0 | (codepoint >> 18));
+            result += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    const std::string &text;
+    size_t position = 0;
+};
+
+struct BenchOptions
+{
+    std::string modelPath;
+    std::string configPath;
+    std::string corpusPath;
+    std::string dictPath;
+    std::string cacheDir;
+    std::string decoderPath; // 拆分导出的流与声码器模型，设置时--model为文本编码器，流式合成按窗口增量解码
+    std::string outputPath;
+    std::vector<uint16_t> threads;
+    int iterations = 3;
+    float speechRate = 1.0f;
+    bool singleSpeaker = true;
+    int lookahead = -1; // 发音队列预合成上限（毫秒），小于0不测量队列播放
+    uint16_t sessions = 1; // 推理会话数，大于1时分句并行合成，--threads为每个会话的线程数
+};
+
+static void printUsage()
+{
+    std::cerr << "usage: speaker_bench --model <model.onnx> --config <model.json> --corpus <corpus.txt>\n"
+              << "                     [--dict <frontend.dict>] [--threads 1,2,4] [--iterations 3]\n"
+              << "                     [--speech-rate 1.0] [--multi-speaker] [--optimized-model-cache <dir>]\n"
+              << "                     [--lookahead <ms>] [--decoder <decoder.onnx>] [--sessions 1]\n"
+              << "                     [--output <report.json>]\n"
+              << "corpus: one utterance per line, either space separated phoneme ids or text (requires --dict)\n"
+              << "lookahead: also play the corpus through the utterance queue in real time and report gaps between utterances\n"
+              << "decoder: split export, --model is the text encoder and streaming decodes the latent in windows\n"
+              << "sessions: run that many sessions with --threads each and synthesize the sentences of an utterance in parallel\n";
+}
+
+static std::string readFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("open failed: " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+static BenchOptions parseOptions(int argc, char **argv)
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string name = argv[i];
+        if (name == "--multi-speaker")
+        {
+            options.singleSpeaker = false;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            throw std::runtime_error("missing value for " + name);
+        }
+        std::string value = argv[++i];
+        if (name == "--model")
+            options.modelPath = value;
+        else if (name == "--config")
+            options.configPath = value;
+        else if (name == "--corpus")
+            options.corpusPath = value;
+        else if (name == "--dict")
+            options.dictPath = value;
+        else if (name == "--decoder")
+            options.decoderPath = value;
+        else if (name == "--optimized-model-cache")
+            options.cacheDir = value;
+        else if (name == "--output")
+            options.outputPath = value;
+        else if (name == "--iterations")
+            options.iterations = std::max(1, std::atoi(value.c_str()));
+        else if (name == "--sessions")
+            options.sessions = static_cast<uint16_t>(std::max(1, std::atoi(value.c_str())));
+        else if (name == "--lookahead")
+            options.lookahead = std::atoi(value.c_str());
+        else if (name == "--speech-rate")
+            options.speechRate = std::strtof(value.c_str(), nullptr);
+        else if (name == "--threads")
+        {
+            std::stringstream stream(value);
+            std::string item;
+            while (std::getline(stream, item, ','))
+            {
+                options.threads.push_back(static_cast<uint16_t>(std::atoi(item.c_str())));
+            }
+        }
+        else
+            throw std::runtime_error("unknown option " + name);
+    }
+    if (options.modelPath.empty() || options.configPath.empty() || options.corpusPath.empty())
+    {
+        throw std::runtime_error("--model, --config and --corpus are required");
+    }
+    if (options.threads.empty())
+    {
+        // 默认测量1线程、半数核心与全部核心
+        uint16_t cores = static_cast<uint16_t>(std::max(1u, std::thread::hardware_concurrency()));
+        options.threads = {1, static_cast<uint16_t>(std::max(1, cores / 2)), cores};
+        std::sort(options.threads.begin(), options.threads.end());
+        options.threads.erase(std::unique(options.threads.begin(), options.threads.end()), options.threads.end());
+    }
+    return options;
+}
+
+static speaker::ModelConfig loadModelConfig(const BenchOptions &options)
+{
+    std::string text = readFile(options.configPath);
+    JsonValue root = JsonParser(text).parse();
+    speaker::ModelConfig modelConfig;
+    modelConfig.singleSpeaker = options.singleSpeaker;
+    if (const JsonValue *data = root.get("data"))
+    {
+        if (const JsonValue *value = data->get("max_wav_value"))
+            modelConfig.maxWavValue = static_cast<float>(value->number);
+        if (const JsonValue *value = data->get("sampling_rate"))
+            modelConfig.sampleRate = static_cast<uint32_t>(value->number);
+        if (const JsonValue *value = data->get("output_gain"))
+            modelConfig.outputGain = static_cast<float>(value->number);
+    }
+    if (const JsonValue *symbols = root.get("symbols"))
+    {
+        for (const JsonValue &symbol : symbols->array)
+        {
+            modelConfig.symbols.push_back(symbol.string);
+        }
+    }
+    // 与Speaker.js一致的停顿符号，流式合成时作为分句边界
+    const char *pauseSymbols[] = {"，", "。", "！", "？", "；", "…", ",", ".", "!", "?", ";", "~"};
+    for (const char *pauseSymbol : pauseSymbols)
+    {
+        auto it = std::find(modelConfig.symbols.begin(), modelConfig.symbols.end(), pauseSymbol);
+        if (it != modelConfig.symbols.end())
+        {
+            modelConfig.pauseIds.push_back(it - modelConfig.symbols.begin());
+        }
+    }
+    modelConfig.frontendDictPath = options.dictPath;
+    modelConfig.optimizedModelCacheDir = options.cacheDir;
+    modelConfig.decoderModelPath = options.decoderPath;
+    return modelConfig;
+}
+
+// 语料行全部为整数时视为音素ID，否则视为文本
+static bool parsePhonemeIds(const std::string &line, std::vector<int64_t> &phonemeIds)
+{
+    std::stringstream stream(line);
+    std::string item;
+    while (stream >> item)
+    {
+        char *end = nullptr;
+        long long value = std::strtoll(item.c_str(), &end, 10);
+        if (*end != '\0')
+        {
+            phonemeIds.clear();
+            return false;
+        }
+        phonemeIds.push_back(value);
+    }
+    return !phonemeIds.empty();
+}
+
+static std::vector<std::string> loadCorpus(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("open failed: " + path);
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (!line.empty())
+        {
+            lines.push_back(line);
+        }
+    }
+    if (lines.empty())
+    {
+        throw std::runtime_error("corpus is empty: " + path);
+    }
+    return lines;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    double rank = p / 100.0 * (values.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = std::min(lower + 1, values.size() - 1);
+    return values[lower] + (values[upper] - values[lower]) * (rank - lower);
+}
+
+// 峰值RSS（KB）
+static long peakRss()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// 当前RSS（KB）
+static long currentRss()
+{
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, residentPages = 0;
+    statm >> pages >> residentPages;
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static std::string jsonPercentiles(const std::vector<double> &values)
+{
+    std::ostringstream stream;
+    stream << "{\"p50\": " << percentile(values, 50) << ", \"p90\": " << percentile(values, 90)
+           << ", \"p99\": " << percentile(values, 99) << ", \"max\": " << percentile(values, 100) << "}";
+    return stream.str();
+}
+
+// 全部语句一次性加入发音队列并实时播放（空输出端），统计相邻语句间的播放停顿
+static std::string runQueue(speaker::Speaker &instance, const BenchOptions &options, const std::vector<std::vector<int64_t>> &inputs)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t done = 0;
+    std::vector<double> gaps;
+    auto startTime = std::chrono::steady_clock::now();
+    for (const std::vector<int64_t> &phonemeIds : inputs)
+    {
+        instance.enqueueUtterance(phonemeIds, 0, options.speechRate, 0, false, [&](speaker::UtteranceState state, const speaker::SynthesisResult &result, int gapDuration, const std::string &error)
+                                  {
+                                      std::lock_guard<std::mutex> lock(mutex);
+                                      if (state == speaker::UtteranceState::Completed)
+                                      {
+                                          gaps.push_back(gapDuration);
+                                      }
+                                      done++;
+                                      condition.notify_all(); });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return done == inputs.size(); });
+    }
+    double wallDuration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    // 首句前的等待是首块延迟而非停顿
+    if (!gaps.empty())
+    {
+        gaps.erase(gaps.begin());
+    }
+    double totalGap = 0.0;
+    size_t stalls = 0;
+    for (double gap : gaps)
+    {
+        totalGap += gap;
+        stalls += gap > 0.0 ? 1 : 0;
+    }
+    std::ostringstream stream;
+    stream << "{\"lookaheadMs\": " << options.lookahead
+           << ", \"wallMs\": " << wallDuration
+           << ", \"stalls\": " << stalls
+           << ", \"totalGapMs\": " << totalGap
+           << ", \"gapMs\": " << jsonPercentiles(gaps) << "}";
+    return stream.str();
+}
+
+static std::string runThreads(const BenchOptions &options, const speaker::ModelConfig &modelConfig, const std::vector<std::string> &corpus, uint16_t numThreads)
+{
+    speaker::PlaybackConfig playbackConfig;
+    playbackConfig.sampleRate = modelConfig.sampleRate;
+    playbackConfig.realtime = false;
+    if (options.lookahead >= 0)
+    {
+        playbackConfig.lookaheadDuration = static_cast<uint32_t>(options.lookahead);
+    }
+    speaker::CacheConfig cacheConfig;
+    cacheConfig.memoryCapacity = 0; // 关闭缓存，每次都实际推理
+
+    auto loadStart = std::chrono::steady_clock::now();
+    std::unique_ptr<speaker::Speaker> instance(new speaker::Speaker());
+    speaker::PlacementConfig placementConfig;
+    placementConfig.sessions = options.sessions;
+    instance->initialize(options.modelPath, modelConfig, numThreads, "null", "", playbackConfig, cacheConfig, placementConfig);
+    double loadDuration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+    std::vector<std::vector<int64_t>> inputs(corpus.size());
+    for (size_t i = 0; i < corpus.size(); i++)
+    {
+        if (!parsePhonemeIds(corpus[i], inputs[i]))
+        {
+            instance->textToPhonemeIds(corpus[i], inputs[i]);
+        }
+    }
+
+    // 预热一句，排除首次推理的初始化开销（首次推理耗时单独报告）
+    speaker::SynthesisResult warmupResult;
+    std::vector<int16_t> warmupBuffer;
+    instance->synthesize(inputs.front(), 0, options.speechRate, warmupBuffer, warmupResult);
+
+    std::vector<double> rtfs, firstChunks;
+    double totalWall = 0.0, totalAudio = 0.0;
+    auto benchStart = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        for (const std::vector<int64_t> &phonemeIds : inputs)
+        {
+            size_t audioSamples = 0;
+            double firstChunk = -1.0;
+            auto startTime = std::chrono::steady_clock::now();
+            speaker::SynthesisResult result;
+            instance->synthesizeStream(phonemeIds, 0, options.speechRate, [&](std::vector<int16_t> &chunk, const speaker::SynthesisResult &chunkResult)
+                                       {
+                                           if (firstChunk < 0.0)
+                                           {
+                                               firstChunk = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+                                           }
+                                           audioSamples += chunk.size();
+                                           return true; },
+                                       result);
+            double wallDuration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            double audioDuration = audioSamples * 1000.0 / modelConfig.sampleRate;
+            if (audioDuration <= 0.0)
+            {
+                continue;
+            }
+            rtfs.push_back(wallDuration / audioDuration);
+            firstChunks.push_back(firstChunk);
+            totalWall += wallDuration;
+            totalAudio += audioDuration;
+        }
+    }
+    double benchDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - benchStart).count();
+    std::string queueReport = options.lookahead >= 0 ? runQueue(*instance, options, inputs) : "null";
+
+    std::ostringstream stream;
+    stream << "    {\"threads\": " << numThreads
+           << ", \"placement\": \"" << instance->getPlacement().describe() << "\""
+           << ", \"loadMs\": " << loadDuration
+           << ", \"firstInferMs\": " << warmupResult.inferDuration
+           << ", \"utterances\": " << rtfs.size()
+           << ",\n     \"rtf\": " << jsonPercentiles(rtfs)
+           << ",\n     \"firstChunkMs\": " << jsonPercentiles(firstChunks)
+           << ",\n     \"meanRtf\": " << (totalAudio > 0.0 ? totalWall / totalAudio : 0.0)
+           << ", \"audioSecondsPerSecond\": " << (benchDuration > 0.0 ? totalAudio / 1000.0 / benchDuration : 0.0)
+           << ", \"utterancesPerSecond\": " << (benchDuration > 0.0 ? rtfs.size() / benchDuration : 0.0)
+           << ",\n     \"queue\": " << queueReport
+           << ",\n     \"rssKB\": " << currentRss()
+           << ", \"peakRssKB\": " << peakRss() << "}";
+    return stream.str();
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        BenchOptions options = parseOptions(argc, argv);
+        speaker::ModelConfig modelConfig = loadModelConfig(options);
+        std::vector<std::string> corpus = loadCorpus(options.corpusPath);
+
+        std::ostringstream report;
+        report << "{\n  \"model\": \"" << options.modelPath << "\",\n"
+               << "  \"decoder\": \"" << options.decoderPath << "\",\n"
+               << "  \"sessions\": " << options.sessions << ",\n"
+               << "  \"corpus\": \"" << options.corpusPath << "\",\n"
+               << "  \"utterances\": " << corpus.size() << ",\n"
+               << "  \"iterations\": " << options.iterations << ",\n"
+               << "  \"speechRate\": " << options.speechRate << ",\n"
+               << "  \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << ",\n"
+               << "  \"results\": [\n";
+        for (size_t i = 0; i < options.threads.size(); i++)
+        {
+            std::cerr << "running " << options.threads[i] << " thread(s)..." << std::endl;
+            report << runThreads(options, modelConfig, corpus, options.threads[i]) << (i + 1 < options.threads.size() ? ",\n" : "\n");
+        }
+        report << "  ]\n}\n";
+
+        if (options.outputPath.empty())
+        {
+            std::cout << report.str();
+        }
+        else
+        {
+            std::ofstream output(options.outputPath);
+            output << report.str();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
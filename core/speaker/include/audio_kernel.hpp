@@ -0,0 +1,31 @@
+#ifndef SPEAKER_AUDIO_KERNEL_H_
+#define SPEAKER_AUDIO_KERNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace speaker
+{
+
+    // 音频数值内核，按编译目标选择NEON（aarch64）、AVX2、SSE2实现，否则使用标量实现
+
+    // 求采样绝对值的峰值
+    float peakAbs(
+        const float *data, // 浮点采样
+        size_t count       // 采样数
+    );
+
+    // 按比例缩放并饱和转换为int16（向零取整，与static_cast一致）
+    void scaleToInt16(
+        const float *src, // 浮点采样
+        int16_t *dst,     // int16采样，需预留count个元素
+        size_t count,     // 采样数
+        float scale       // 缩放比例
+    );
+
+    // 当前使用的实现名称
+    const char *audioKernelName();
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef SPEAKER_CPU_TOPOLOGY_H_
+#define SPEAKER_CPU_TOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace speaker
+{
+
+    // 算力相同的一组核心（如RK3588的4个A76与4个A55）
+    struct CpuCluster
+    {
+        uint32_t capacity = 0;  // 相对算力（cpu_capacity，缺失时取最高频率kHz）
+        std::vector<int> cpus;  // 逻辑核心编号
+    };
+
+    // 线程放置配置
+    struct PlacementConfig
+    {
+        std::string inferenceCluster = "auto"; // 推理线程所在簇：auto（大小核架构时选大核）、big、little、none（不绑定）
+        bool pinAudio = true;                  // 是否为实时音频线程保留专用核心
+        uint16_t sessions = 1;                 // 推理会话数，大于1时各会话独占一组核心，长文本各分句并行合成
+    };
+
+    // 线程放置结果
+    struct ThreadPlacement
+    {
+        std::vector<CpuCluster> clusters;  // 按算力从高到低排列的核心簇
+        std::vector<int> inferenceCpus;    // 推理线程核心（每个推理线程绑定一个核心，为空不绑定）
+        std::vector<int> audioCpus;        // 实时音频线程核心（为空不绑定）
+        std::vector<std::vector<int>> sessionCpus; // 各推理会话的核心（由inferenceCpus依次均分，为空不绑定）
+
+        // 放置描述，如"clusters=[4-7]@1024,[0-3]@414 inference=4-7 sessions=4-5|6-7 audio=3"
+        std::string describe() const;
+    };
+
+    // 从sysfs读取在线核心并按算力分簇，读取失败时返回空
+    std::vector<CpuCluster> readCpuClusters(const std::string &sysfsRoot = "/sys/devices/system/cpu");
+
+    // 按配置为推理线程与音频线程规划核心，numThreads为每个推理会话的线程数（0为占满首选簇，由各会话均分）
+    ThreadPlacement planThreadPlacement(const std::vector<CpuCluster> &clusters, uint16_t numThreads, const PlacementConfig &config);
+
+    // 生成ORT的session.intra_op_thread_affinities配置（调用线程自身不在其中，核心编号从1开始）
+    std::string formatIntraOpAffinities(const std::vector<int> &cpus);
+
+    // 将当前线程绑定到指定核心，失败时返回false
+    bool setCurrentThreadAffinity(const std::vector<int> &cpus);
+
+    // 作用域内将当前线程绑定到指定核心，离开作用域恢复原亲和性
+    class ScopedThreadAffinity
+    {
+    public:
+        explicit ScopedThreadAffinity(const std::vector<int> &cpus);
+        ~ScopedThreadAffinity();
+
+        ScopedThreadAffinity(const ScopedThreadAffinity &) = delete;
+        ScopedThreadAffinity &operator=(const ScopedThreadAffinity &) = delete;
+
+    private:
+        std::vector<int> previousCpus;
+        bool applied = false;
+    };
+
+}
+
+#endif
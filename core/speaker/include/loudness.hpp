@@ -0,0 +1,72 @@
+#ifndef SPEAKER_LOUDNESS_H_
+#define SPEAKER_LOUDNESS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace speaker
+{
+
+    // 前瞻限幅器配置
+    struct LimiterConfig
+    {
+        float gain = 1.0f;          // 固定增益，模型输出乘以该值即为int16刻度
+        float threshold = 32767.0f; // 限幅阈值（int16刻度）
+        uint32_t lookahead = 80;    // 前瞻窗口（样本数），输出延迟lookahead - 1个样本
+        uint32_t release = 800;     // 增益恢复时间常数（样本数）
+    };
+
+    // 流式响度级：固定增益后经前瞻限幅转换为int16，可逐块处理且块间保持状态，无需等待整段音频
+    // 在前瞻窗口内对所需增益取滑动最小值再做等长滑动平均，峰值到达输出端前增益已平滑降至所需值；
+    // 限幅未生效且整块无需限幅时（标定增益后的常态）走向量化内核，只有峰值附近的块逐样本处理
+    class StreamingLimiter
+    {
+    public:
+        StreamingLimiter() = default;
+        explicit StreamingLimiter(const LimiterConfig &config);
+
+        // 重新配置并复位
+        void configure(const LimiterConfig &config);
+
+        // 处理一块浮点采样，返回写入out的样本数（累计输入不足lookahead - 1个样本时只进入延迟线）
+        size_t process(
+            const float *data, // 浮点采样
+            size_t count,      // 采样数
+            int16_t *out       // int16采样，需预留count个元素
+        );
+
+        // 输出延迟线中剩余的样本并复位，返回写入out的样本数（至多latency()个）
+        size_t flush(int16_t *out);
+
+        // 复位状态，丢弃延迟线中的样本
+        void reset();
+
+        // 输出延迟（样本数）
+        size_t latency() const { return config.lookahead - 1; }
+
+        // 累计触发限幅的样本数
+        uint64_t limitedSamples() const { return limited; }
+
+    private:
+        bool push(float sample, int16_t &out);
+        size_t passThrough(const float *data, size_t count, int16_t *out);
+
+        LimiterConfig config;
+        float releaseCoefficient = 0.0f;
+        std::vector<float> delayLine;    // 已缩放的延迟采样
+        std::vector<float> holdValues;   // 最近lookahead个滑动最小值，用于滑动平均
+        std::vector<uint64_t> minIndex;  // 单调队列：样本序号
+        std::vector<float> minValue;     // 单调队列：所需增益
+        size_t minHead = 0;
+        size_t minTail = 0;
+        double holdSum = 0.0;
+        float envelope = 1.0f;
+        uint64_t position = 0; // 已输入的样本数
+        uint64_t relaxedFrom = 0; // 自该样本序号起滑动最小值与滑动平均均为1（限幅已完全退出）
+        uint64_t limited = 0;
+    };
+
+}
+
+#endif
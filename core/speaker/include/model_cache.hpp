@@ -0,0 +1,24 @@
+#ifndef SPEAKER_MODEL_CACHE_H_
+#define SPEAKER_MODEL_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include <onnxruntime_cxx_api.h>
+
+namespace speaker
+{
+
+    // 模型文件内容哈希，打开失败时抛出异常
+    uint64_t hashFile(const std::string &path);
+
+    // 优化模型缓存键：模型内容哈希、ORT版本与CPU架构（ORT_ENABLE_ALL的布局优化与硬件相关）
+    std::string optimizedModelCacheKey(const std::string &modelPath);
+
+    // 创建推理会话：cacheDir非空时加载已缓存的优化模型并跳过图优化，
+    // 未命中时以原模型完成图优化并将优化结果写入缓存，供下次启动复用
+    Ort::Session createCachedSession(Ort::Env &env, const std::string &modelPath, const Ort::SessionOptions &options, Ort::PrepackedWeightsContainer &prepackedWeights, const std::string &cacheDir);
+
+}
+
+#endif
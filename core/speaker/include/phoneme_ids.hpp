@@ -0,0 +1,50 @@
+#ifndef SPEAKER_PHONEME_IDS_H_
+#define SPEAKER_PHONEME_IDS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace speaker
+{
+
+    // 音素ID只读视图：直接引用调用方内存（JS侧Int16Array或原生int64向量），不持有数据
+    // 仅在写入推理输入张量时才转换为int64，调用方需保证视图使用期间内存有效
+    class PhonemeIdsView
+    {
+    public:
+        PhonemeIdsView() = default;
+        PhonemeIdsView(const std::vector<int64_t> &phonemeIds) : wide(phonemeIds.data()), length(phonemeIds.size()) {}
+        PhonemeIdsView(const int16_t *phonemeIds, size_t length) : narrow(phonemeIds), length(length) {}
+
+        size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+
+        int64_t operator[](size_t index) const
+        {
+            return narrow != nullptr ? static_cast<int64_t>(narrow[index]) : wide[index];
+        }
+
+        // 转换写入dst（至少size()个元素）
+        void copyTo(int64_t *dst) const
+        {
+            if (narrow != nullptr)
+            {
+                std::copy(narrow, narrow + length, dst);
+            }
+            else if (wide != nullptr)
+            {
+                std::copy(wide, wide + length, dst);
+            }
+        }
+
+    private:
+        const int16_t *narrow = nullptr;
+        const int64_t *wide = nullptr;
+        size_t length = 0;
+    };
+
+}
+
+#endif
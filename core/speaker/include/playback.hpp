@@ -0,0 +1,190 @@
+#ifndef SPEAKER_PLAYBACK_H_
+#define SPEAKER_PLAYBACK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ring_buffer.hpp"
+
+namespace speaker
+{
+
+    // 回放配置
+    struct PlaybackConfig
+    {
+        uint32_t sampleRate = 16000;         // 采样率
+        uint32_t periodSize = 256;           // 周期大小（帧）
+        uint32_t bufferSize = 1024;          // 设备缓冲区大小（帧）
+        uint32_t ringBufferDuration = 60000; // 环形缓冲区容量（毫秒）
+        uint32_t queueLength = 100;          // 发音队列最大排队语句数
+        uint32_t lookaheadDuration = 10000;  // 发音队列预合成上限（已合成未播放的音频时长，毫秒），0为逐句合成播放；已预合成的语句不再参与优先级排序
+        uint32_t idleTimeout = 200;          // 环形缓冲区持续为空多久后排空设备（毫秒，不短于设备缓冲时长），期间到达的音频无缝续播
+        bool realtime = true;                // 回放线程是否使用实时调度
+        std::vector<int> cpus;               // 回放线程绑定核心，为空不绑定
+    };
+
+    // 音频输出端
+    class AudioSink
+    {
+    public:
+        virtual ~AudioSink() = default;
+
+        // 打开设备，periodSize/bufferSize可能被设备调整
+        virtual void open(PlaybackConfig &config) = 0;
+
+        // 写入音频帧，阻塞直到全部写入
+        virtual void write(const int16_t *data, size_t frames) = 0;
+
+        // 等待已写入的音频播放完成
+        virtual void drain() = 0;
+
+        // 丢弃已写入但未播放的音频
+        virtual void drop() = 0;
+
+        // 欠载恢复次数
+        virtual uint64_t xrunCount() const { return 0; }
+    };
+
+#ifdef USE_ALSA
+    // ALSA输出端，优先使用mmap访问方式
+    class AlsaSink : public AudioSink
+    {
+    public:
+        explicit AlsaSink(const std::string &deviceName);
+        ~AlsaSink() override;
+
+        void open(PlaybackConfig &config) override;
+        void write(const int16_t *data, size_t frames) override;
+        void drain() override;
+        void drop() override;
+        uint64_t xrunCount() const override { return xruns; }
+
+    private:
+        void recover(int error);
+
+        std::string deviceName;
+        struct _snd_pcm *pcmHandle = nullptr;
+        bool mmapAccess = false;
+        std::atomic<uint64_t> xruns{0};
+    };
+#endif
+
+    // 空输出端，按实时速率丢弃音频，用于无声卡环境
+    class NullSink : public AudioSink
+    {
+    public:
+        void open(PlaybackConfig &config) override;
+        void write(const int16_t *data, size_t frames) override;
+        void drain() override {}
+        void drop() override {}
+
+    private:
+        uint32_t sampleRate = 16000;
+    };
+
+    // WAV文件输出端，不做实时节流，用于测试与离线渲染
+    class WavSink : public AudioSink
+    {
+    public:
+        explicit WavSink(const std::string &filePath);
+        ~WavSink() override;
+
+        void open(PlaybackConfig &config) override;
+        void write(const int16_t *data, size_t frames) override;
+        void drain() override;
+        void drop() override {}
+
+    private:
+        void writeHeader();
+
+        std::string filePath;
+        std::FILE *file = nullptr;
+        uint32_t sampleRate = 16000;
+        uint32_t dataSize = 0;
+    };
+
+    // 根据设备名称创建输出端："null"为空输出端，"wav:<路径>"为WAV文件，其余为ALSA设备
+    std::unique_ptr<AudioSink> createAudioSink(const std::string &deviceName);
+
+    // 异步回放引擎：专用回放线程从无锁环形缓冲区取数据写入输出端
+    class PlaybackEngine
+    {
+    public:
+        PlaybackEngine() = default;
+        ~PlaybackEngine();
+
+        PlaybackEngine(const PlaybackEngine &) = delete;
+        PlaybackEngine &operator=(const PlaybackEngine &) = delete;
+
+        // 打开输出端并启动回放线程
+        void start(std::unique_ptr<AudioSink> sink, const PlaybackConfig &config);
+
+        // 停止回放线程
+        void stop();
+
+        // 写入待播放音频，缓冲区满时等待回放线程腾出空间，等待期间收到清空请求则放弃剩余数据
+        void enqueue(const int16_t *data, size_t samples);
+
+        // 丢弃所有未播放的音频
+        void flush();
+
+        // 等待所有已写入音频播放完成（立即排空设备，不等待空闲超时）
+        void drain();
+
+        // 跳过回放位置[begin, end)内的音频（位置以累计写入样本数计，end可为无穷大并在之后以相同begin收窄），
+        // 区间已开始播放时同时丢弃设备缓冲
+        void skip(uint64_t begin, uint64_t end);
+
+        // 累计写入样本数，即下一个写入样本的回放位置
+        uint64_t enqueuedPosition() const { return enqueuedSamples.load(); }
+
+        // 等待回放位置到达position（已播放或已丢弃）
+        void waitPlayed(uint64_t position);
+
+        // 等待已写入未播放的样本数低于samples，abort置位时提前返回
+        void waitQueuedBelow(uint64_t samples, const std::atomic<bool> &abort);
+
+        // 是否有未播放完的音频
+        bool busy() const;
+
+        // 欠载恢复次数
+        uint64_t xrunCount() const;
+
+        const PlaybackConfig &getConfig() const { return config; }
+
+    private:
+        void run();
+        void wakeUp();
+        size_t applySkips(size_t &frames);
+
+        PlaybackConfig config;
+        std::unique_ptr<AudioSink> sink;
+        RingBuffer<int16_t> ringBuffer;
+        std::thread thread;
+        std::atomic<bool> running{false};
+        std::atomic<bool> flushRequested{false};
+        std::atomic<bool> drainRequested{false};
+        std::atomic<uint64_t> flushGeneration{0}; // 清空请求计数，用于中止等待中的写入
+        std::atomic<bool> idle{true};
+        std::atomic<uint64_t> enqueuedSamples{0};
+        std::atomic<uint64_t> playedSamples{0};
+        std::mutex producerMutex; // 串行化多个生产者，回放线程不获取此锁
+        std::mutex stateMutex;    // 仅用于空闲等待与状态通知
+        std::mutex skipMutex;
+        std::map<uint64_t, uint64_t> skipRanges; // 待跳过区间：起始位置 -> 结束位置
+        std::atomic<bool> skipPending{false};
+        bool skipDropped = false; // 当前跳过区间是否已丢弃设备缓冲（回放线程）
+        std::condition_variable dataCv;
+        std::condition_variable stateCv;
+    };
+
+}
+
+#endif
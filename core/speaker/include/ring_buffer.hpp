@@ -0,0 +1,119 @@
+#ifndef SPEAKER_RING_BUFFER_H_
+#define SPEAKER_RING_BUFFER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace speaker
+{
+
+    // 单生产者单消费者无锁环形缓冲区
+    // 仅允许一个线程调用write，一个线程调用read/discard
+    template <typename T>
+    class RingBuffer
+    {
+    public:
+        explicit RingBuffer(size_t capacity = 0)
+        {
+            resize(capacity);
+        }
+
+        RingBuffer(const RingBuffer &) = delete;
+        RingBuffer &operator=(const RingBuffer &) = delete;
+
+        // 重设容量（向上取整到2的幂），调用时不得有并发读写
+        void resize(size_t capacity)
+        {
+            size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            buffer.assign(size, T());
+            mask = size - 1;
+            head.store(0, std::memory_order_relaxed);
+            tail.store(0, std::memory_order_relaxed);
+        }
+
+        size_t capacity() const
+        {
+            return buffer.size();
+        }
+
+        // 可读元素数
+        size_t size() const
+        {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+
+        // 可写元素数
+        size_t space() const
+        {
+            return capacity() - size();
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        // 写入数据，返回实际写入的元素数（生产者线程）
+        size_t write(const T *data, size_t count)
+        {
+            size_t writeIndex = head.load(std::memory_order_relaxed);
+            size_t readIndex = tail.load(std::memory_order_acquire);
+            count = std::min(count, capacity() - (writeIndex - readIndex));
+            size_t offset = writeIndex & mask;
+            size_t firstPart = std::min(count, capacity() - offset);
+            std::memcpy(&buffer[offset], data, firstPart * sizeof(T));
+            std::memcpy(&buffer[0], data + firstPart, (count - firstPart) * sizeof(T));
+            head.store(writeIndex + count, std::memory_order_release);
+            return count;
+        }
+
+        // 读取数据，返回实际读取的元素数（消费者线程）
+        size_t read(T *data, size_t count)
+        {
+            size_t readIndex = tail.load(std::memory_order_relaxed);
+            size_t writeIndex = head.load(std::memory_order_acquire);
+            count = std::min(count, writeIndex - readIndex);
+            size_t offset = readIndex & mask;
+            size_t firstPart = std::min(count, capacity() - offset);
+            std::memcpy(data, &buffer[offset], firstPart * sizeof(T));
+            std::memcpy(data + firstPart, &buffer[0], (count - firstPart) * sizeof(T));
+            tail.store(readIndex + count, std::memory_order_release);
+            return count;
+        }
+
+        // 丢弃全部可读数据，返回丢弃的元素数（消费者线程）
+        size_t discard()
+        {
+            size_t readIndex = tail.load(std::memory_order_relaxed);
+            size_t writeIndex = head.load(std::memory_order_acquire);
+            tail.store(writeIndex, std::memory_order_release);
+            return writeIndex - readIndex;
+        }
+
+        // 丢弃至多count个可读数据，返回丢弃的元素数（消费者线程）
+        size_t discard(size_t count)
+        {
+            size_t readIndex = tail.load(std::memory_order_relaxed);
+            size_t writeIndex = head.load(std::memory_order_acquire);
+            count = std::min(count, writeIndex - readIndex);
+            tail.store(readIndex + count, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        std::vector<T> buffer;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> head{0}; // 写位置
+        alignas(64) std::atomic<size_t> tail{0}; // 读位置
+    };
+
+}
+
+#endif
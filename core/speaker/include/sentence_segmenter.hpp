@@ -0,0 +1,46 @@
+#ifndef SPEAKER_SENTENCE_SEGMENTER_H_
+#define SPEAKER_SENTENCE_SEGMENTER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace speaker
+{
+
+    // 增量分句：上游（如大模型逐token输出）逐段追加文本，检测到句末标点即切出完整句子；
+    // 句中停顿（逗号等）在当前句已足够长时也作为边界，首句使用较短的长度使合成尽早开始
+    class SentenceSegmenter
+    {
+    public:
+        // 设置逗号处切句的最小字数（不含空白与标点）
+        void configure(
+            size_t firstClauseLength, // 首句
+            size_t clauseLength       // 后续各句
+        );
+
+        // 追加文本片段，切出的完整句子追加到sentences；
+        // 句末标点位于片段末尾时等待下一片段，以便将其后的引号括号并入本句、区分小数点与句点
+        void append(const std::string &fragment, std::vector<std::string> &sentences);
+
+        // 文本结束，剩余文本作为最后一句输出
+        void finish(std::vector<std::string> &sentences);
+
+        // 丢弃未切出的文本
+        void reset();
+
+    private:
+        void scan(bool finishing, std::vector<std::string> &sentences);
+        void emit(size_t end, std::vector<std::string> &sentences);
+
+        std::string buffer;       // 未切出的文本
+        size_t position = 0;      // 已扫描到的字节位置
+        size_t length = 0;        // 当前句已扫描的有效字数
+        size_t count = 0;         // 已切出的句数
+        size_t firstClauseLength = 6;
+        size_t clauseLength = 40;
+    };
+
+}
+
+#endif
@@ -1,14 +1,33 @@
 #ifndef SPEAKER_H_
 #define SPEAKER_H_
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <onnxruntime_cxx_api.h>
 
+#include "cpu_topology.hpp"
+#include "loudness.hpp"
+#include "phoneme_ids.hpp"
+#include "playback.hpp"
+#include "sentence_segmenter.hpp"
+#include "synthesis_cache.hpp"
+#include "text_frontend.hpp"
+#include "utterance_queue.hpp"
+
 namespace speaker
 {
 
@@ -21,12 +40,41 @@ namespace speaker
         float noiseScale = 0.667f;
         float noiseW = 0.8f;
         bool singleSpeaker = false; // 是否为单音色
+        std::vector<int64_t> pauseIds;  // 停顿符号ID（流式合成时作为分句边界）
+        uint32_t minChunkLength = 16;   // 流式合成最小分块音素数
+        uint32_t fadeDuration = 8;      // 分块拼接处淡入淡出时长（毫秒）
+        bool memoryArena = false;       // 是否启用CPU内存池与内存复用模式
+        uint32_t phonemeBucketSize = 0; // 音素长度分桶粒度（输入补齐到其整数倍，0为不补齐）
+        uint32_t maxBatchSize = 8;      // 批量合成单次推理的最大句数
+        std::vector<std::string> symbols; // 模型符号表（原生文本前端使用）
+        std::string frontendDictPath;     // 原生文本前端词典路径，为空不启用
+        std::string optimizedModelCacheDir; // 优化模型缓存目录，为空时每次启动重新执行图优化
+        bool warmup = false;                // 初始化时是否以代表性输入预热推理
+        float outputGain = 0.0f;            // 固定输出增益（模型输出乘以该值后经前瞻限幅转为int16），0为名义增益maxWavValue
+        uint32_t limiterLookahead = 5;      // 前瞻限幅窗口（毫秒），即输出延迟
+        uint32_t limiterRelease = 50;       // 限幅增益恢复时间（毫秒）
+        std::string decoderModelPath;       // 拆分导出的流与声码器模型路径，非空时主模型为文本编码器与时长预测（输出潜变量z）
+        uint32_t decodeWindow = 32;         // 增量解码窗口（潜变量帧数）
+        uint32_t decodeContext = 10;        // 增量解码窗口两侧的重叠上下文（帧数，参与计算但输出时裁去）
+    };
+
+    // 进程内共享的推理运行时：所有Speaker实例共用同一Ort::Env与预打包权重容器，
+    // 多个实例加载同一模型时不再重复占用预打包权重内存
+    struct Runtime
+    {
+        Ort::Env env;
+        Ort::PrepackedWeightsContainer prepackedWeights;
+
+        Runtime();
+
+        // 获取共享运行时，最后一个实例释放后销毁
+        static std::shared_ptr<Runtime> get();
     };
 
     // onnx模型会话
     struct ModelSession
     {
-        Ort::Env env;
+        std::shared_ptr<Runtime> runtime; // 需先于session构造、后于session析构
         Ort::Session session;
         Ort::AllocatorWithDefaultOptions allocator;
         Ort::SessionOptions options;
@@ -34,11 +82,59 @@ namespace speaker
         ModelSession() : session(nullptr){};
     };
 
+    // 推理上下文：输入张量与IoBinding预先创建并复用，稳态推理的输入不再逐次分配；
+    // 输出张量长度无法预知，仍由会话分配器按次分配（启用内存池时复用arena内存块）
+    struct InferenceContext
+    {
+        Ort::MemoryInfo memoryInfo;
+        Ort::RunOptions runOptions;
+        Ort::IoBinding binding;
+        std::vector<int64_t> phonemeIds;             // 音素ID输入缓冲区（长度为当前分桶长度）
+        std::array<int64_t, 2> phonemeIdsShape{1, 0};
+        std::array<int64_t, 1> phonemeIdsLength{0};
+        std::array<float, 3> scales{0.0f, 0.0f, 0.0f};
+        std::array<int64_t, 1> speakerId{0};
+        Ort::Value phonemeIdsTensor;
+        Ort::Value phonemeIdsLengthTensor;
+        Ort::Value scalesTensor;
+        Ort::Value speakerIdTensor;
+        std::mutex mutex; // 上下文被多个调用共享，推理需串行
+
+        InferenceContext() : memoryInfo(nullptr), runOptions(nullptr), binding(nullptr),
+                             phonemeIdsTensor(nullptr), phonemeIdsLengthTensor(nullptr),
+                             scalesTensor(nullptr), speakerIdTensor(nullptr){};
+    };
+
+    // 推理单元：独立的模型会话与推理上下文，多会话时各绑定一组核心并行合成不同分句
+    struct InferenceWorker
+    {
+        ModelSession session;          // 完整模型，拆分导出时为文本编码器与时长预测
+        ModelSession decoder;          // 拆分导出的流与声码器，未拆分时为空
+        InferenceContext context;
+        std::vector<int> runCpus;      // 调用Run的线程在推理期间绑定的核心
+        bool utteranceRunning = false; // 是否正在执行发音队列语句的推理（由terminateMutex保护）
+
+        InferenceWorker() = default;
+        ~InferenceWorker();
+
+        // 派发并行合成任务到本单元的常驻线程（首次派发时创建），按派发顺序执行
+        void post(std::function<void()> task);
+
+    private:
+        void run();
+
+        std::thread thread;
+        std::mutex taskMutex;
+        std::condition_variable taskCondition;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+    };
+
     // 模型对象
     struct Model
     {
         ModelConfig config;
-        ModelSession session;
+        std::vector<std::unique_ptr<InferenceWorker>> workers; // 推理单元，首个为默认单元
     };
 
     // 合成结果
@@ -46,38 +142,268 @@ namespace speaker
     {
         int inferDuration; // 推理时长
         int audioDuration; // 音频时长
+        int firstChunkDuration; // 首块延迟（从调用到首块音频就绪）
+    };
+
+    // 分块合成回调：每块合成完成后调用，可移走chunk中的音频数据，返回false时停止合成
+    using ChunkCallback = std::function<bool(
+        std::vector<int16_t> &chunk,         // 分块音频数据
+        const SynthesisResult &chunkResult   // 分块合成结果
+    )>;
+
+    // 增量解码窗口回调：last为本句最后一个窗口，返回false时停止解码
+    using WindowCallback = std::function<bool(
+        std::vector<int16_t> &window,         // 窗口音频数据
+        const SynthesisResult &windowResult, // 窗口合成结果
+        bool last                            // 是否为最后一个窗口
+    )>;
+
+    // 发音队列语句的结束状态
+    enum class UtteranceState
+    {
+        Completed, // 播放完成
+        Cancelled, // 排队中被移除或合成播放中被打断
+        Failed     // 合成失败
+    };
+
+    // 语句结束回调：在发音线程或取消调用线程中调用
+    using UtteranceCallback = std::function<void(
+        UtteranceState state,          // 结束状态
+        const SynthesisResult &result, // 合成结果（被取消时为已完成部分）
+        int gapDuration,               // 与上一句之间的播放停顿（毫秒，上一句播完时本句尚无音频就绪的时长）
+        const std::string &error       // 失败原因
+    )>;
+
+    // 发音队列中的语句
+    struct Utterance : UtteranceTrack
+    {
+        uint64_t id = 0;
+        uint64_t textId = 0;             // 所属增量文本会话，0为独立语句
+        std::vector<int64_t> phonemeIds; // 音素ID（入队时复制）
+        uint16_t speakerId = 0;
+        float speechRate = 1.0f;
+        UtteranceCallback onDone;
+        SynthesisResult result{};
+        std::string error;
+        std::chrono::steady_clock::time_point enqueueTime;    // 入队时间
+        std::chrono::steady_clock::time_point firstWriteTime; // 首块音频写入回放引擎的时间
     };
 
-    // 加载模型
-    void initialize(
-        const std::string &modelPath,       // vits模型路径
-        const ModelConfig &modelConfig,     // vits模型配置
-        const uint16_t &numThreads,         // 推理线程数
-        const std::string &audioDeviceName, // 音频设备名称
-        const std::string &audioMixerName   // 音频混音器名称
-    );
-
-    // 设置音频设备音量
-    void setVolume(
-        const uint16_t &volume // 音频音量
-    );
-
-    // 合成语音
-    void synthesize(
-        std::vector<int64_t> &phonemeIds,  // 音素ID向量
-        const uint16_t &speakerId,         // 音色ID
-        const float &speechRate,           // 语速
-        std::vector<int16_t> &audioBuffer, // 合成音频数据
-        SynthesisResult &result            // 合成结果
-    );
-
-    void say(
-        std::vector<int64_t> &phonemeIds, // 音素ID向量
-        const uint16_t &speakerId,        // 音色ID
-        const float &speechRate,          // 语速
-        const bool &block,                // 播放是否阻塞
-        SynthesisResult &result           // 合成结果
-    );
+    // 增量文本会话结束回调：会话已结束（endText或cancelText）且各句均已结束时调用
+    using TextCallback = std::function<void(
+        UtteranceState state,          // 结束状态（任一句被取消即为取消，任一句失败即为失败）
+        const SynthesisResult &result, // 各句合计（首块延迟为首次追加文本到首句开始播放）
+        size_t sentences,              // 入队句数
+        const std::string &error       // 失败原因
+    )>;
+
+    // 增量文本会话：上游逐段追加文本，切出完整句子即转换音素加入发音队列，
+    // 各句同优先级先进先出，仅首句按会话设置打断当前语句；任一句被取消时整个会话取消
+    struct TextSession
+    {
+        uint64_t id = 0;
+        uint16_t speakerId = 0;
+        float speechRate = 1.0f;
+        int priority = 0;
+        bool interrupt = false;
+        SentenceSegmenter segmenter;
+        std::mutex appendMutex; // 串行化分句与入队，保证各句按文本顺序入队
+        std::mutex mutex;       // 保护以下状态（语句结束回调中访问）
+        size_t sentences = 0;   // 已入队句数
+        size_t pending = 0;     // 已入队未结束句数
+        bool ended = false;     // 是否已结束追加（endText或cancelText）
+        bool cancelled = false;
+        bool notified = false;
+        bool hasText = false;   // 是否已追加过文本
+        SynthesisResult result{};
+        std::string error;
+        std::chrono::steady_clock::time_point firstTextTime; // 首次追加文本的时间
+        TextCallback onDone;
+    };
+
+    // 发音器：独立持有模型会话、推理上下文、回放引擎与合成缓存，多个实例可并发合成
+    class Speaker
+    {
+    public:
+        Speaker() = default;
+        ~Speaker();
+
+        Speaker(const Speaker &) = delete;
+        Speaker &operator=(const Speaker &) = delete;
+
+        // 加载模型
+        void initialize(
+            const std::string &modelPath,         // vits模型路径
+            const ModelConfig &modelConfig,       // vits模型配置
+            const uint16_t &numThreads,           // 推理线程数
+            const std::string &audioDeviceName,   // 音频设备名称（打开失败时回退为空输出端，仍可合成）
+            const std::string &audioMixerName,    // 音频混音器名称
+            const PlaybackConfig &playbackConfig, // 回放配置
+            const CacheConfig &cacheConfig,       // 合成缓存配置
+            const PlacementConfig &placementConfig = PlacementConfig() // 线程放置配置
+        );
+
+        // 获取线程放置结果
+        const ThreadPlacement &getPlacement() const { return placement; }
+
+        // 设置音频设备音量
+        void setVolume(
+            const uint16_t &volume // 音频音量
+        );
+
+        // 合成语音
+        void synthesize(
+            const PhonemeIdsView &phonemeIds,  // 音素ID
+            const uint16_t &speakerId,         // 音色ID
+            const float &speechRate,           // 语速
+            std::vector<int16_t> &audioBuffer, // 合成音频数据
+            SynthesisResult &result            // 合成结果
+        );
+
+        // 批量合成语音：多句补齐后单次推理，再按各句有效长度拆分输出
+        void synthesizeBatch(
+            const std::vector<PhonemeIdsView> &phonemeIdsBatch, // 各句音素ID
+            const uint16_t &speakerId,                          // 音色ID
+            const float &speechRate,                            // 语速
+            std::vector<std::vector<int16_t>> &audioBuffers,    // 各句合成音频数据
+            SynthesisResult &result                             // 合成结果（各句合计）
+        );
+
+        // 分句流式合成：按停顿符号切分后逐块合成，每块完成即通过回调交付；
+        // 加载拆分模型时每句编码一次后按窗口增量解码，每个窗口完成即交付，首块延迟与句长无关；
+        // 多个推理会话时各分句由各会话并行合成，按原顺序交付
+        void synthesizeStream(
+            const PhonemeIdsView &phonemeIds, // 音素ID
+            const uint16_t &speakerId,        // 音色ID
+            const float &speechRate,          // 语速
+            const ChunkCallback &onChunk,     // 分块回调
+            SynthesisResult &result           // 合成结果（各块合计）
+        );
+
+        // 文本转音素ID（需加载原生文本前端词典）
+        void textToPhonemeIds(
+            const std::string &text,         // 文本
+            std::vector<int64_t> &phonemeIds // 音素ID向量
+        ) const;
+
+        // 是否已加载原生文本前端
+        bool hasTextFrontend() const;
+
+        // 获取合成缓存统计
+        CacheStats getCacheStats() const;
+
+        // 按停顿符号切分音素ID序列
+        void splitPhonemeIds(
+            const PhonemeIdsView &phonemeIds,         // 音素ID
+            std::vector<std::vector<int64_t>> &chunks // 切分后的音素块
+        ) const;
+
+        // 合成语音并播放（立即打断：取消发音队列中的全部语句并丢弃未播放音频）
+        void say(
+            const PhonemeIdsView &phonemeIds, // 音素ID
+            const uint16_t &speakerId,        // 音色ID
+            const float &speechRate,          // 语速
+            const bool &block,                // 是否阻塞至播放完成，否则写入回放队列后立即返回
+            const bool &stream,               // 是否分句流式合成播放
+            SynthesisResult &result           // 合成结果
+        );
+
+        // 语句加入发音队列，由发音线程按优先级依次分句合成，结束时调用onDone；队列已满时抛出异常
+        // 回放配置lookaheadDuration大于0时为流水线模式：当前语句播放期间即预合成后续语句，相邻语句无缝衔接；
+        // 预合成的音频已写入回放引擎，之后加入的高优先级语句（不打断时）排在其后播放，
+        // 优先级只对尚未取出合成的语句生效，需严格按优先级播放时使用interrupt或将lookaheadDuration设为0
+        uint64_t enqueueUtterance(
+            const PhonemeIdsView &phonemeIds, // 音素ID
+            const uint16_t &speakerId,        // 音色ID
+            const float &speechRate,          // 语速
+            const int &priority,              // 优先级，数值越大越先播放
+            const bool &interrupt,            // 是否打断优先级不高于此语句的当前语句
+            const UtteranceCallback &onDone   // 结束回调
+        );
+
+        // 取消优先级不高于maxPriority的排队语句与当前语句：中止进行中的推理并立即丢弃未播放音频，返回取消的语句数
+        size_t cancelUtterances(
+            const int &maxPriority = std::numeric_limits<int>::max() // 取消的最高优先级
+        );
+
+        // 开始增量文本会话（需加载原生文本前端），返回会话ID；会话需以endText或cancelText结束
+        uint64_t beginText(
+            const uint16_t &speakerId, // 音色ID
+            const float &speechRate,   // 语速
+            const int &priority,       // 优先级
+            const bool &interrupt,     // 首句是否打断优先级不高于此会话的当前语句
+            const TextCallback &onDone // 结束回调
+        );
+
+        // 追加文本片段：切出的完整句子立即转换音素加入发音队列，返回本次入队的句数；会话已取消时忽略
+        size_t appendText(
+            const uint64_t &id,          // 会话ID
+            const std::string &fragment // 文本片段
+        );
+
+        // 结束追加：剩余文本作为最后一句入队
+        void endText(
+            const uint64_t &id // 会话ID
+        );
+
+        // 取消并结束会话：取消其排队与在途语句并丢弃未播放音频，返回取消的语句数
+        size_t cancelText(
+            const uint64_t &id // 会话ID
+        );
+
+    private:
+        void initializeWorker(InferenceWorker &worker, const std::string &modelPath, const std::vector<int> &cpus, const uint16_t &numThreads);
+        void initializeContext(InferenceWorker &worker);
+        void warmUp(InferenceWorker &worker);
+        void bindPhonemeIds(InferenceContext &context, const PhonemeIdsView &phonemeIds);
+        int runContext(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate);
+        void infer(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<int16_t> &audioBuffer, SynthesisResult &result);
+        void synthesize(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<int16_t> &audioBuffer, SynthesisResult &result);
+        bool incremental() const { return !model.config.decoderModelPath.empty(); }
+        int encode(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<float> &latent, int64_t &channels);
+        int decode(InferenceWorker &worker, const std::vector<float> &latent, int64_t channels, int64_t begin, int64_t end, const uint16_t &speakerId, std::vector<float> &window, std::vector<float> &audio);
+        bool inferIncremental(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const WindowCallback &onWindow);
+        bool synthesizeIncremental(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const bool &fadeIn, const bool &fadeOut, const ChunkCallback &onChunk);
+        void synthesizeParallel(const std::vector<std::vector<int64_t>> &chunks, const uint16_t &speakerId, const float &speechRate, const ChunkCallback &onChunk);
+        std::string cacheKey(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, bool windowed) const;
+        bool lookupCache(const std::string &key, std::vector<int16_t> &audioBuffer, SynthesisResult &result);
+        size_t trimPadding(const float *audio, size_t samples) const;
+        StreamingLimiter &threadLimiter() const;
+        void convertAudio(const float *audio, size_t samples, int16_t *audioBuffer) const;
+        void inferBatch(InferenceWorker &worker, const std::vector<PhonemeIdsView> &phonemeIdsBatch, const std::vector<size_t> &indices, const uint16_t &speakerId, const float &speechRate, std::vector<std::vector<int16_t>> &audioBuffers, SynthesisResult &result);
+        void applyFade(std::vector<int16_t> &audioBuffer, const bool &fadeIn, const bool &fadeOut) const;
+        void sayStream(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, SynthesisResult &result);
+        uint64_t enqueue(std::shared_ptr<Utterance> utterance, const bool &interrupt);
+        std::shared_ptr<TextSession> findText(const uint64_t &id);
+        void enqueueSentences(const std::shared_ptr<TextSession> &session, const std::vector<std::string> &sentences);
+        size_t cancelSentences(const std::shared_ptr<TextSession> &session);
+        void finishSentence(const std::shared_ptr<TextSession> &session, const Utterance &utterance, UtteranceState state, const SynthesisResult &result, const std::string &error);
+        void notifyText(const std::shared_ptr<TextSession> &session);
+        void processUtterances();
+        void processCompletions();
+        void applyCancellation(std::vector<std::shared_ptr<Utterance>> &removed, const std::vector<PlaybackRange> &skips, bool writingCancelled);
+        void beginRun(InferenceWorker &worker);
+        void endRun(InferenceWorker &worker);
+
+        Model model;
+        PlaybackEngine playback;
+        SynthesisCache cache;
+        TextFrontend frontend;
+        ThreadPlacement placement;
+        LimiterConfig limiterConfig; // 各合成路径共用的响度级配置
+        std::string audioDeviceName;
+        std::string audioMixerName;
+        UtteranceQueue<Utterance> utterances;
+        std::thread utteranceThread;           // 发音线程：按优先级取出语句合成并写入回放引擎
+        std::thread completionThread;          // 完成线程：按写入顺序等待各语句播放完成并通知
+        uint64_t lookaheadSamples = 0;         // 预合成上限（样本数），0为逐句合成播放
+        std::atomic<uint64_t> nextUtteranceId{1};
+        std::mutex textMutex;                                        // 保护增量文本会话表
+        std::map<uint64_t, std::shared_ptr<TextSession>> textSessions; // 未结束的增量文本会话
+        std::atomic<uint64_t> nextTextId{1};
+        Utterance *writingUtterance = nullptr; // 发音线程正在合成的语句（由terminateMutex保护）
+        std::mutex terminateMutex;             // 保护发音队列语句的推理状态与各推理单元的RunOptions终止标志
+    };
 
 }
 
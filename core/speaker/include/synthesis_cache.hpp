@@ -0,0 +1,113 @@
+#ifndef SPEAKER_SYNTHESIS_CACHE_H_
+#define SPEAKER_SYNTHESIS_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "phoneme_ids.hpp"
+
+namespace speaker
+{
+
+    // 合成缓存配置
+    struct CacheConfig
+    {
+        uint32_t memoryCapacity = 32; // 内存LRU缓存容量（MB），0为不启用
+        std::string filePath;         // 持久化缓存文件路径，为空不启用；同一文件只能由一个实例打开
+        uint32_t fileCapacity = 256;  // 持久化缓存文件容量（MB），写满后不再追加
+    };
+
+    // 缓存统计
+    struct CacheStats
+    {
+        uint64_t hits = 0;          // 命中次数
+        uint64_t misses = 0;        // 未命中次数
+        uint64_t memoryHits = 0;    // 内存缓存命中次数
+        uint64_t fileHits = 0;      // 持久化缓存命中次数
+        uint64_t memoryEntries = 0; // 内存缓存条目数
+        uint64_t memorySize = 0;    // 内存缓存占用（字节）
+        uint64_t fileEntries = 0;   // 持久化缓存条目数
+        uint64_t fileSize = 0;      // 持久化缓存已用空间（字节）
+    };
+
+    // 合成结果缓存：内存LRU + 内存映射的持久化文件（写穿），以合成参数为键保存int16音频
+    class SynthesisCache
+    {
+    public:
+        SynthesisCache() = default;
+        ~SynthesisCache();
+
+        SynthesisCache(const SynthesisCache &) = delete;
+        SynthesisCache &operator=(const SynthesisCache &) = delete;
+
+        // 打开缓存，fingerprint标识模型，与持久化文件记录的不一致时清空文件
+        void open(const CacheConfig &config, uint64_t fingerprint);
+
+        // 关闭缓存并解除文件映射
+        void close();
+
+        bool enabled() const { return memoryCapacity > 0 || mapping != nullptr; }
+
+        // 生成缓存键
+        static std::string makeKey(
+            const PhonemeIdsView &phonemeIds,       // 音素ID
+            uint16_t speakerId,                     // 音色ID
+            float speechRate,                       // 语速
+            float noiseScale,
+            float lengthScale,
+            float noiseW);
+
+        // 查找缓存，命中时将音频追加到audioBuffer
+        bool lookup(const std::string &key, std::vector<int16_t> &audioBuffer);
+
+        // 写入缓存
+        void insert(const std::string &key, const int16_t *data, size_t samples);
+
+        CacheStats stats() const;
+
+        // 64位FNV-1a哈希
+        static uint64_t hash(const void *data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+    private:
+        struct MemoryEntry
+        {
+            std::string key;
+            std::vector<int16_t> audio;
+        };
+
+        struct FileRecord
+        {
+            const int16_t *audio;
+            size_t samples;
+        };
+
+        void openFile(const std::string &filePath, size_t capacity, uint64_t fingerprint);
+        void resetFile(uint64_t fingerprint);
+        void insertFile(const std::string &key, const int16_t *data, size_t samples);
+        void insertMemory(const std::string &key, const int16_t *data, size_t samples);
+
+        mutable std::mutex mutex;
+        size_t memoryCapacity = 0;
+        size_t memorySize = 0;
+        std::list<MemoryEntry> memoryEntries; // 头部为最近使用
+        std::unordered_map<std::string, std::list<MemoryEntry>::iterator> memoryIndex;
+
+        int fileDescriptor = -1;
+        uint8_t *mapping = nullptr;
+        size_t mappingSize = 0;
+        std::unordered_map<std::string_view, FileRecord> fileIndex; // 键指向映射区域
+
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t memoryHits = 0;
+        uint64_t fileHits = 0;
+    };
+
+}
+
+#endif
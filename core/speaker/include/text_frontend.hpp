@@ -0,0 +1,83 @@
+#ifndef SPEAKER_TEXT_FRONTEND_H_
+#define SPEAKER_TEXT_FRONTEND_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace speaker
+{
+
+    // 双数组字典树（键为UTF-8字节序列）
+    // 节点s经字节c转移到base[s]+c+1，经结束符转移到base[s]，check记录父节点
+    // 结束符节点的base为-(值+1)
+    struct TrieUnit
+    {
+        int32_t base;
+        int32_t check;
+    };
+
+    // 普通话文本前端：基于内存映射词典完成数字转写、分词、注音并直接输出音素ID
+    class TextFrontend
+    {
+    public:
+        TextFrontend() = default;
+        ~TextFrontend();
+
+        TextFrontend(const TextFrontend &) = delete;
+        TextFrontend &operator=(const TextFrontend &) = delete;
+
+        // 加载词典，symbols为模型符号表（下标即音素ID）
+        void load(const std::string &dictPath, const std::vector<std::string> &symbols);
+
+        bool loaded() const { return mapping != nullptr; }
+
+        // 文本转音素ID（含空白符间隔），加载后只读，可并发调用
+        void textToPhonemeIds(const std::string &text, std::vector<int64_t> &phonemeIds) const;
+
+        // 由文本词典（每行：词 词频 拼音1 拼音2 ...，拼音以数字标调）构建二进制词典
+        static void buildDictionary(const std::string &lexiconPath, const std::string &dictPath);
+
+        // 数字拼音转注音，如"zhong1" -> "ㄓㄨㄥ"
+        static std::string pinyinToBopomofo(const std::string &pinyin);
+
+        // 阿拉伯数字转中文读法
+        static std::string normalizeNumbers(const std::string &text);
+
+    private:
+        struct Entry
+        {
+            float logFrequency;      // 对数词频
+            uint32_t syllableOffset; // 音节ID起始位置
+            uint32_t syllableCount;  // 音节数（与词的字数一致）
+        };
+
+        struct Syllable
+        {
+            uint32_t offset; // 注音字符串在字符串池中的偏移
+            uint32_t length;
+        };
+
+        void close();
+        void appendSegment(const std::string &text, const std::vector<size_t> &offsets, size_t begin, size_t end, std::vector<int64_t> &ids) const;
+        void appendSymbol(char32_t codepoint, std::vector<int64_t> &ids) const;
+
+        int fileDescriptor = -1;
+        uint8_t *mapping = nullptr;
+        size_t mappingSize = 0;
+        const TrieUnit *units = nullptr;
+        uint32_t unitCount = 0;
+        const Entry *entries = nullptr;
+        const uint16_t *syllableIds = nullptr;
+        float minLogFrequency = 0.0f;
+
+        std::unordered_map<char32_t, int64_t> symbolIds;
+        std::vector<int64_t> syllablePhonemeIds;                  // 各音节对应的音素ID，加载时预先转换
+        std::vector<std::pair<uint32_t, uint32_t>> syllableRanges; // 音节在syllablePhonemeIds中的范围
+        std::unordered_map<char32_t, std::vector<int64_t>> latinPhonemeIds;
+    };
+
+}
+
+#endif
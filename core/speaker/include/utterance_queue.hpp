@@ -0,0 +1,271 @@
+#ifndef SPEAKER_UTTERANCE_QUEUE_H_
+#define SPEAKER_UTTERANCE_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace speaker
+{
+
+    // 回放区间：以回放引擎累计写入样本数计的位置[begin, end)
+    struct PlaybackRange
+    {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // 语句的调度状态，由UtteranceQueue在锁内维护
+    struct UtteranceTrack
+    {
+        int priority = 0;                   // 优先级，数值越大越先播放
+        std::atomic<bool> cancelled{false}; // 是否已被取消
+        bool started = false;               // 是否已写入回放引擎
+        bool written = false;               // 是否已全部写入（或合成结束）
+        bool finished = false;              // 是否已结束（已从队列移除并通知）
+        uint64_t begin = 0;                 // 首个样本的回放位置
+        uint64_t end = 0;                   // 末尾样本之后的回放位置
+    };
+
+    // 有界优先级发音队列：排队语句按优先级（同优先级先进先出）取出合成，
+    // 已取出未结束的语句按写入回放引擎的顺序记录，预合成时可有多句同时在途
+    // T需派生自UtteranceTrack
+    template <typename T>
+    class UtteranceQueue
+    {
+    public:
+        using Pointer = std::shared_ptr<T>;
+
+        void setCapacity(size_t _capacity)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            capacity = _capacity;
+        }
+
+        // 加入语句，队列已满或已关闭时返回false；
+        // interrupt为true时取消优先级不高于新语句的在途语句，输出参数同cancel
+        bool push(Pointer item, bool interrupt, std::vector<Pointer> &removed, std::vector<PlaybackRange> &skips, bool &writingCancelled)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writingCancelled = false;
+            if (closed || pending.size() >= capacity)
+            {
+                return false;
+            }
+            if (interrupt)
+            {
+                int maxPriority = item->priority;
+                cancelInFlight([maxPriority](const T &other) { return other.priority <= maxPriority; }, removed, skips, writingCancelled);
+            }
+            pending.push_back(std::move(item));
+            condition.notify_all();
+            return true;
+        }
+
+        // 取出优先级最高的排队语句加入在途列表，队列为空时等待，关闭后返回空指针
+        Pointer pop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return closed || !pending.empty(); });
+            if (closed)
+            {
+                return nullptr;
+            }
+            auto next = pending.begin();
+            for (auto it = pending.begin(); it != pending.end(); ++it)
+            {
+                if ((*it)->priority > (*next)->priority)
+                {
+                    next = it;
+                }
+            }
+            Pointer item = std::move(*next);
+            pending.erase(next);
+            inFlight.push_back(item);
+            return item;
+        }
+
+        // 写入音频前调用：已被取消时返回false，首次写入时记录起始位置
+        bool beginWrite(T &item, uint64_t position)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (item.cancelled)
+            {
+                return false;
+            }
+            if (!item.started)
+            {
+                item.started = true;
+                item.begin = position;
+            }
+            return true;
+        }
+
+        // 合成结束后调用：记录结束位置，返回是否已被取消（被取消时skip为需跳过的完整区间）
+        bool endWrite(T &item, uint64_t position, PlaybackRange &skip)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            item.written = true;
+            item.end = item.started ? position : item.begin;
+            skip = {item.begin, item.end};
+            condition.notify_all();
+            return item.cancelled;
+        }
+
+        // 取消优先级不高于maxPriority的排队语句与在途语句，返回取消的语句数：
+        // removed为需通知的语句（排队语句与已全部写入的在途语句），skips为需跳过的回放区间，
+        // 正在合成的语句仅标记取消并置writingCancelled，由合成方在endWrite后结束
+        size_t cancel(int maxPriority, std::vector<Pointer> &removed, std::vector<PlaybackRange> &skips, bool &writingCancelled)
+        {
+            return cancelIf([maxPriority](const T &item) { return item.priority <= maxPriority; }, removed, skips, writingCancelled);
+        }
+
+        // 取消满足条件的排队语句与在途语句（条件在锁内调用），参数与返回值同cancel
+        template <typename Predicate>
+        size_t cancelIf(Predicate predicate, std::vector<Pointer> &removed, std::vector<PlaybackRange> &skips, bool &writingCancelled)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writingCancelled = false;
+            size_t count = cancelInFlight(predicate, removed, skips, writingCancelled);
+            std::vector<Pointer> remaining;
+            for (Pointer &item : pending)
+            {
+                if (predicate(*item))
+                {
+                    item->cancelled = true;
+                    item->finished = true;
+                    removed.push_back(std::move(item));
+                    count++;
+                }
+                else
+                {
+                    remaining.push_back(std::move(item));
+                }
+            }
+            pending.swap(remaining);
+            condition.notify_all();
+            return count;
+        }
+
+        // 等待最早的在途语句全部写入并返回；关闭且无在途语句时返回空指针
+        Pointer front()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return (!inFlight.empty() && inFlight.front()->written) || (closed && inFlight.empty()); });
+            return inFlight.empty() ? nullptr : inFlight.front();
+        }
+
+        // 结束语句并从在途列表移除，已结束时返回false（保证每句只通知一次）
+        bool finish(const Pointer &item)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (item->finished)
+            {
+                return false;
+            }
+            item->finished = true;
+            for (auto it = inFlight.begin(); it != inFlight.end(); ++it)
+            {
+                if (*it == item)
+                {
+                    inFlight.erase(it);
+                    break;
+                }
+            }
+            condition.notify_all();
+            return true;
+        }
+
+        // 等待语句结束或队列关闭
+        void waitFinished(const Pointer &item)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&] { return item->finished || closed; });
+        }
+
+        // 等待所有在途语句停止写入
+        void waitWritten()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] {
+                for (const Pointer &item : inFlight)
+                {
+                    if (!item->written)
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        }
+
+        // 关闭队列并取消全部语句，参数与返回值同cancel
+        size_t close(std::vector<Pointer> &removed, std::vector<PlaybackRange> &skips, bool &writingCancelled)
+        {
+            size_t count = cancel(std::numeric_limits<int>::max(), removed, skips, writingCancelled);
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            condition.notify_all();
+            return count;
+        }
+
+        // 排队中的语句数（不含在途语句）
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return pending.size();
+        }
+
+    private:
+        template <typename Predicate>
+        size_t cancelInFlight(Predicate predicate, std::vector<Pointer> &removed, std::vector<PlaybackRange> &skips, bool &writingCancelled)
+        {
+            size_t count = 0;
+            std::deque<Pointer> remaining;
+            for (Pointer &item : inFlight)
+            {
+                if (item->cancelled || !predicate(*item))
+                {
+                    remaining.push_back(std::move(item));
+                    continue;
+                }
+                item->cancelled = true;
+                count++;
+                if (!item->written)
+                {
+                    // 仍在合成：已写入部分先跳过至无穷远，合成方endWrite后以实际结束位置收窄
+                    if (item->started)
+                    {
+                        skips.push_back({item->begin, std::numeric_limits<uint64_t>::max()});
+                    }
+                    writingCancelled = true;
+                    remaining.push_back(std::move(item));
+                    continue;
+                }
+                if (item->end > item->begin)
+                {
+                    skips.push_back({item->begin, item->end});
+                }
+                item->finished = true;
+                removed.push_back(std::move(item));
+            }
+            inFlight.swap(remaining);
+            return count;
+        }
+
+        mutable std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<Pointer> pending; // 排队语句，按入队顺序排列，取出时选择最先入队的最高优先级语句
+        std::deque<Pointer> inFlight; // 在途语句，按写入回放引擎的顺序排列
+        size_t capacity = 100;
+        bool closed = false;
+    };
+
+}
+
+#endif
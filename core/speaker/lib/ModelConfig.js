@@ -51,4 +51,32 @@ export default class ModelConfig {
         return this.#data["symbols"] || [];
     }
 
+    /**
+     * 默认加载的模型精度（fp32 / int8 / int8-static等）
+     */
+    get precision() {
+        return this.#data["precision"] || "fp32";
+    }
+
+    /**
+     * 各精度模型路径（相对模型配置文件所在目录），如{ "int8": "moss.int8.onnx" }
+     */
+    get variants() {
+        return this.#data["variants"] || {};
+    }
+
+    /**
+     * 固定输出增益（tools/calibrate_gain.py标定），为0时使用标称增益max_wav_value
+     */
+    get outputGain() {
+        return this.data["output_gain"] || 0;
+    }
+
+    /**
+     * 拆分导出的模型路径（相对模型配置文件所在目录），如{ "encoder": "moss.encoder.onnx", "decoder": "moss.decoder.onnx" }
+     */
+    get split() {
+        return this.#data["split"] || null;
+    }
+
 }
\ No newline at end of file
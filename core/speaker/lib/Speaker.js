@@ -1,23 +1,61 @@
+import path from "path";
 import fs from "fs-extra";
 import VError from "verror";
 import AsyncLock from "async-lock";
 import _ from "lodash";
 import { createRequire } from 'module';
 const require = createRequire(import.meta.url);
-const speaker = require('../build/Release/speaker');
+const native = require('../build/Release/speaker');
 import textCleaners from "./text_cleaners/index.js";
 import ModelConfig from "./ModelConfig.js";
+import SpeechSession from "./SpeechSession.js";
 
 const lock = new AsyncLock();
 
+// 停顿符号（流式合成时作为分句边界）
+const PAUSE_SYMBOLS = ["，", "。", "！", "？", "；", "…", ",", ".", "!", "?", ";", "~"];
+
 /**
  * @typedef {Object} SpeakerOptions
  * @property {string} modelPath - 模型路径
  * @property {string} modelConfigPath - 模型配置路径
- * @property {number} numThreads - 推理线程数
+ * @property {string} precision - 模型精度（默认取模型配置的precision，非fp32时加载对应的量化模型）
+ * @property {number} numThreads - 推理线程数（多会话时为每个会话的线程数）
  * @property {number} lengthScale - 时长缩放
  * @property {number} noiseScale - 
  * @property {number} noiseW - 
+ * @property {boolean} memoryArena - 是否启用推理内存池与内存复用模式
+ * @property {number} phonemeBucketSize - 音素长度分桶粒度（输入补齐到其整数倍以复用内存，0为不补齐）
+ * @property {number} maxBatchSize - 批量合成单次推理的最大句数
+ * @property {string} frontendDictPath - 原生文本前端词典路径（由build_dict构建，设置后文本处理在原生层完成）
+ * @property {string} optimizedModelCacheDir - 优化模型缓存目录（图优化结果按模型哈希与ORT版本缓存，下次启动直接加载）
+ * @property {boolean} warmup - 是否在初始化时预热推理（首次合成即达到稳态延迟）
+ * @property {object} loudness - 响度配置
+ * @property {number} loudness.outputGain - 固定输出增益（默认取模型配置的output_gain，由tools/calibrate_gain.py标定；为0时使用名义增益maxWavValue）
+ * @property {number} loudness.limiterLookahead - 前瞻限幅窗口（毫秒），即输出延迟
+ * @property {number} loudness.limiterRelease - 限幅增益恢复时间（毫秒）
+ * @property {object} decoding - 增量解码配置（模型配置含split时加载拆分导出的编码器与解码器，流式合成按窗口解码）
+ * @property {boolean} decoding.incremental - 是否启用增量解码（默认模型配置含split时启用）
+ * @property {number} decoding.window - 解码窗口（潜变量帧数）
+ * @property {number} decoding.context - 窗口两侧重叠上下文（帧数）
+ * @property {string} audioDeviceName - 音频设备名称（"null"为空输出，"wav:<路径>"为写入WAV文件）
+ * @property {string} audioMixerName - 音频混音器名称
+ * @property {object} playback - 回放配置
+ * @property {number} playback.periodSize - 周期大小（帧）
+ * @property {number} playback.bufferSize - 设备缓冲区大小（帧）
+ * @property {number} playback.ringBufferDuration - 回放缓冲区容量（毫秒）
+ * @property {number} playback.queueLength - 发音队列最大排队语句数（对应配置playback_queue_length）
+ * @property {number} playback.lookaheadDuration - 发音队列预合成上限（已合成未播放的音频时长，毫秒，0为逐句合成播放；已预合成的语句不再参与优先级排序）
+ * @property {number} playback.idleTimeout - 回放缓冲区持续为空多久后排空设备（毫秒），期间到达的音频无缝续播
+ * @property {boolean} playback.realtime - 回放线程是否使用实时调度
+ * @property {object} placement - 线程放置配置
+ * @property {string} placement.inferenceCluster - 推理线程所在核心簇（auto：大小核架构时选大核 / big / little / none：不绑定）
+ * @property {boolean} placement.pinAudio - 是否为回放线程保留专用核心
+ * @property {number} placement.sessions - 推理会话数（大于1时各会话独占numThreads个核心，长文本各分句并行合成）
+ * @property {object} cache - 合成缓存配置
+ * @property {number} cache.memoryCapacity - 内存缓存容量（MB，0为不启用）
+ * @property {string} cache.filePath - 持久化缓存文件路径（重启后仍可命中，同一文件只能由一个实例打开）
+ * @property {number} cache.fileCapacity - 持久化缓存文件容量（MB）
  */
 
 export default class Speaker {
@@ -25,15 +63,30 @@ export default class Speaker {
     modelPath;
     modelConfigPath;
     modelConfig;
+    precision;
     numThreads;
     lengthScale;
     noiseScale;
     noiseW;
     singleSpeaker;
+    memoryArena;
+    phonemeBucketSize;
+    maxBatchSize;
+    frontendDictPath;
+    optimizedModelCacheDir;
+    warmup;
+    loudness;
+    decoding;
+    decoderModelPath = null;  // 拆分导出的流与声码器模型路径（启用增量解码时modelPath为文本编码器）
     audioDeviceName;
     audioMixerName;
+    playback;
+    cache;
+    placement;
+    threadPlacement = null;  // 初始化后的线程放置结果
     currnetVolume;
     symbolMap = {};
+    #native = new native.Speaker();  // 原生发音器实例，多个实例共享推理运行时
     #initialized = false;
 
     /**
@@ -41,50 +94,136 @@ export default class Speaker {
      * @param {SpeakerOptions} options - 构造函数
      */
     constructor(options = {}) {
-        const { modelPath, modelConfigPath, numThreads, lengthScale, noiseScale, noiseW, singleSpeaker, audioDeviceName, audioMixerName } = options;
+        const { modelPath, modelConfigPath, precision, numThreads, lengthScale, noiseScale, noiseW, singleSpeaker, memoryArena, phonemeBucketSize, maxBatchSize, frontendDictPath, optimizedModelCacheDir, warmup, loudness, decoding, audioDeviceName, audioMixerName, playback, placement, cache } = options;
         if(!_.isString(modelPath) || !fs.pathExistsSync(modelPath))
             throw new VError("model file not found: %s", modelPath || "");
         if(!_.isString(modelConfigPath) || !fs.pathExistsSync(modelConfigPath))
             throw new VError("model config file not found: %s", modelConfigPath || "");
         if(!_.isFinite(numThreads))
             throw new VError("inference num threads invalid");
-        this.modelPath = modelPath;
         this.modelConfigPath = modelConfigPath;
         this.modelConfig = new ModelConfig(fs.readJSONSync(modelConfigPath));
+        this.precision = _.defaultTo(precision, this.modelConfig.precision);
+        this.decoding = _.defaultTo(decoding, {});
+        this.modelPath = this.#resolveModelPath(modelPath);
         this.modelConfig.symbols.forEach((symbol, index) => this.symbolMap[symbol] = index);
         this.numThreads = numThreads;
         this.lengthScale = _.defaultTo(lengthScale, 1.0);
         this.noiseScale = _.defaultTo(noiseScale, 0.667);
         this.noiseW = _.defaultTo(noiseW, 0.8);
         this.singleSpeaker = _.defaultTo(singleSpeaker, false);
+        this.memoryArena = _.defaultTo(memoryArena, false);
+        this.phonemeBucketSize = _.defaultTo(phonemeBucketSize, 0);
+        this.maxBatchSize = _.defaultTo(maxBatchSize, 8);
+        if(!_.isNil(frontendDictPath) && (!_.isString(frontendDictPath) || !fs.pathExistsSync(frontendDictPath)))
+            throw new VError("frontend dictionary file not found: %s", frontendDictPath || "");
+        this.frontendDictPath = _.defaultTo(frontendDictPath, null);
+        this.optimizedModelCacheDir = _.defaultTo(optimizedModelCacheDir, null);
+        this.warmup = _.defaultTo(warmup, true);
+        const { outputGain, ...limiter } = _.defaultTo(loudness, {});
+        this.loudness = { ...limiter, outputGain: _.defaultTo(outputGain, this.modelConfig.outputGain) };
         this.audioDeviceName = _.defaultTo(audioDeviceName, "default");
         this.audioMixerName = _.defaultTo(audioMixerName, "PCM");
+        this.playback = _.defaultTo(playback, {});
+        this.cache = _.defaultTo(cache, {});
+        this.placement = _.defaultTo(placement, {});
     }
 
     /**
-     * 合成语音并发声
+     * 合成语音并发声（立即打断当前播放，并取消发音队列中的全部语句）
      * 
      * @param {string} text - 语音文本
      * @param {object} options - 发音选项
      * @param {number} options.speechRate - 语速（0.1-2.0）
-     * @param {boolean} options.block - 播放是否阻塞
+     * @param {boolean} options.block - 是否等待播放完成（否则写入回放队列后立即返回）
+     * @param {boolean} options.stream - 是否分句流式合成播放（首句合成后即开始播放）
      * @returns {object} - 合成结果
      */
     async say(text, options = {}) {
-        const { speechRate = 1.0, block = false } = options;
+        const { speechRate = 1.0, block = false, stream = false } = options;
         !this.#initialized && await this.#initialize();
-        const phonemeIds = this.#textToPhonemeIds(text);
+        const phonemeIds = this.#toNativeInput(text);
         const {
             inferDuration,  // 推理时长
             audioDuration,  // 音频时长
-        } = await speaker.say(phonemeIds, 0, speechRate, block);
+            firstChunkDuration  // 首块延迟
+        } = await this.#native.say(phonemeIds, 0, speechRate, block, stream);
         return {
             inferDuration,
             audioDuration,
+            firstChunkDuration,
             realTimeFactor: Math.floor(inferDuration / audioDuration * 1000) / 1000
         }
     }
 
+    /**
+     * 语句加入发音队列：按优先级依次分句流式合成播放，高优先级语句可打断当前语句（插话）
+     * 当前语句播放期间即预合成后续语句（上限见playback.lookaheadDuration），相邻语句无缝衔接；
+     * 已预合成的语句已写入回放队列，不打断的高优先级语句排在其后播放，需严格按优先级播放时使用interrupt或将lookaheadDuration设为0
+     * 
+     * @param {string} text - 语音文本
+     * @param {object} options - 发音选项
+     * @param {number} options.speechRate - 语速（0.1-2.0）
+     * @param {number} options.priority - 优先级（数值越大越先播放）
+     * @param {boolean} options.interrupt - 是否打断优先级不高于此语句的当前语句（中止其推理并丢弃未播放音频）
+     * @returns {object} - 语句结果，state为completed（播放完成）或cancelled（被取消），gapDuration为与上一句之间的播放停顿（毫秒）
+     */
+    async speak(text, options = {}) {
+        const { speechRate = 1.0, priority = 0, interrupt = false } = options;
+        !this.#initialized && await this.#initialize();
+        const phonemeIds = this.#toNativeInput(text);
+        const {
+            id,  // 语句ID
+            state,  // 结束状态
+            inferDuration,  // 推理时长
+            audioDuration,  // 音频时长
+            firstChunkDuration,  // 首块延迟
+            gapDuration  // 与上一句之间的播放停顿
+        } = await this.#native.speak(phonemeIds, 0, speechRate, priority, interrupt);
+        return {
+            id,
+            state,
+            inferDuration,
+            audioDuration,
+            firstChunkDuration,
+            gapDuration,
+            realTimeFactor: audioDuration > 0 ? Math.floor(inferDuration / audioDuration * 1000) / 1000 : 0
+        }
+    }
+
+    /**
+     * 开始增量发音会话：逐段追加文本（如大模型流式输出），检测到完整句子即合成并加入发音队列
+     * 各句同优先级按文本顺序播放，任一句被取消（如被更高优先级语句打断）时整个会话取消；需配置frontendDictPath
+     * 
+     * @param {object} options - 发音选项
+     * @param {number} options.speechRate - 语速（0.1-2.0）
+     * @param {number} options.priority - 优先级（数值越大越先播放）
+     * @param {boolean} options.interrupt - 首句是否打断优先级不高于此会话的当前语句
+     * @returns {SpeechSession} - 发音会话
+     */
+    async beginSpeech(options = {}) {
+        const { speechRate = 1.0, priority = 0, interrupt = false } = options;
+        if(!this.frontendDictPath)
+            throw new VError("speech session requires frontendDictPath");
+        !this.#initialized && await this.#initialize();
+        const { id, done } = this.#native.beginText(0, speechRate, priority, interrupt);
+        // 会话结果由end或wait返回，避免未等待时出现未处理的拒绝
+        done.catch(() => {});
+        return new SpeechSession(this.#native, id, done);
+    }
+
+    /**
+     * 取消发音队列中优先级不高于maxPriority的语句，当前语句满足条件时立即中止推理与播放
+     * 
+     * @param {number} maxPriority - 取消的最高优先级（默认取消全部）
+     * @returns {number} - 取消的语句数
+     */
+    async cancel(maxPriority) {
+        if(!this.#initialized)
+            return 0;
+        return await this.#native.cancel(maxPriority);
+    }
+
     /**
      * 设置发声音量
      * 
@@ -92,7 +231,7 @@ export default class Speaker {
      */
     async setVolume(volume = 100) {
         !this.#initialized && await this.#initialize();
-        await speaker.setVolume(volume);
+        await this.#native.setVolume(volume);
         this.currnetVolume = volume;
     }
 
@@ -107,12 +246,12 @@ export default class Speaker {
     async synthesize(text, options = {}) {
         const { speechRate = 1.0 } = options;
         !this.#initialized && await this.#initialize();
-        const phonemeIds = this.#textToPhonemeIds(text);
+        const phonemeIds = this.#toNativeInput(text);
         const {
             data,  // 音频数据(Int16Array)
             inferDuration,  // 推理时长
             audioDuration,  // 音频时长
-        } = await speaker.synthesize(phonemeIds, 0, speechRate);
+        } = await this.#native.synthesize(phonemeIds, 0, speechRate);
         return {
             data,
             inferDuration,
@@ -121,6 +260,130 @@ export default class Speaker {
         }
     }
 
+    /**
+     * 流式合成语音：按停顿符号分句，每句合成完成即产出音频块，消费跟不上时原生合成线程暂停等待
+     * 
+     * @example
+     * for await (const { data } of speaker.synthesizeStream(text))
+     *     socket.write(Buffer.from(data.buffer));
+     * 
+     * @param {string} text 合成文本
+     * @param {object} options - 发音选项
+     * @param {number} options.speechRate - 语速（0.1-2.0）
+     * @param {number} options.highWaterMark - 已合成未被消费的音频块上限
+     * @returns {AsyncGenerator<object>} - 音频块，data为音频数据(Int16Array)
+     */
+    async *synthesizeStream(text, options = {}) {
+        const { speechRate = 1.0, highWaterMark = 2 } = options;
+        !this.#initialized && await this.#initialize();
+        const phonemeIds = this.#toNativeInput(text);
+        const chunks = [];  // 已送达未被消费的音频块
+        const acks = [];  // 对应音频块的确认函数，消费时确认以放行原生合成
+        let wakeup = null, finished = false, cancelled = false, error = null;
+        const notify = () => {
+            wakeup && wakeup();
+            wakeup = null;
+        };
+        const task = this.#native.synthesizeStream(phonemeIds, 0, speechRate, highWaterMark, (data, chunkResult) => {
+            if(cancelled)
+                return false;
+            chunks.push({ data, ...chunkResult });
+            notify();
+            return new Promise(resolve => acks.push(resolve));
+        })
+            .then(() => finished = true, err => error = err)
+            .finally(notify);
+        try {
+            while(true) {
+                if(chunks.length) {
+                    acks.shift()(true);
+                    yield chunks.shift();
+                    continue;
+                }
+                if(error)
+                    throw error;
+                if(finished)
+                    break;
+                await new Promise(resolve => wakeup = resolve);
+            }
+        }
+        finally {
+            // 提前结束迭代时取消剩余合成
+            cancelled = true;
+            acks.splice(0).forEach(ack => ack(false));
+            await task;
+        }
+    }
+
+    /**
+     * 批量合成语音（多句单次推理，适用于预渲染提示音）
+     * 
+     * @param {string[]} texts 合成文本列表
+     * @param {object} options - 发音选项
+     * @param {number} options.speechRate - 语速（0.1-2.0）
+     * @returns {object} - 合成结果，data为与texts一一对应的音频数据(Int16Array)列表
+     */
+    async synthesizeBatch(texts, options = {}) {
+        const { speechRate = 1.0 } = options;
+        !this.#initialized && await this.#initialize();
+        const phonemeIdsBatch = texts.map(text => this.#toNativeInput(text));
+        const {
+            data,  // 音频数据列表
+            inferDuration,  // 推理时长
+            audioDuration,  // 音频时长
+        } = await this.#native.synthesizeBatch(phonemeIdsBatch, 0, speechRate);
+        return {
+            data,
+            inferDuration,
+            audioDuration,
+            realTimeFactor: Math.floor(inferDuration / audioDuration * 1000) / 1000
+        }
+    }
+
+    /**
+     * 获取合成缓存统计
+     * 
+     * @returns {object} - 命中/未命中次数与缓存占用
+     */
+    getCacheStats() {
+        if(!this.#initialized)
+            return null;
+        return this.#native.getCacheStats();
+    }
+
+    /**
+     * 按精度解析模型路径：非fp32时优先取模型配置variants中的路径，否则取模型同目录下的<模型名>.<精度>.onnx；
+     * 启用增量解码时取模型配置split中的编码器路径，并解析解码器路径
+     */
+    #resolveModelPath(modelPath) {
+        const { split } = this.modelConfig;
+        if(split && this.decoding.incremental !== false) {
+            const [encoderPath, decoderPath] = [split.encoder, split.decoder].map(splitPath => path.resolve(path.dirname(this.modelConfigPath), splitPath || ""));
+            if(!split.encoder || !fs.pathExistsSync(encoderPath))
+                throw new VError("encoder model file not found: %s", encoderPath);
+            if(!split.decoder || !fs.pathExistsSync(decoderPath))
+                throw new VError("decoder model file not found: %s", decoderPath);
+            this.decoderModelPath = decoderPath;
+            return encoderPath;
+        }
+        if(this.precision == "fp32")
+            return modelPath;
+        const variantPath = this.modelConfig.variants[this.precision];
+        const resolvedPath = variantPath ?
+            path.resolve(path.dirname(this.modelConfigPath), variantPath) :
+            modelPath.replace(/\.onnx$/, "") + `.${this.precision}.onnx`;
+        if(!fs.pathExistsSync(resolvedPath))
+            throw new VError("%s model file not found: %s", this.precision, resolvedPath);
+        return resolvedPath;
+    }
+
+    /**
+     * 转换为原生层输入：启用原生文本前端时直接传递文本，否则在JS侧转换为音素ID
+     */
+    #toNativeInput(text) {
+        return this.frontendDictPath ? text : this.#textToPhonemeIds(text);
+    }
+
     #textToPhonemeIds(text) {
         const { textCleanerNames } = this.modelConfig;
         const phonemeIds = [];
@@ -130,12 +393,11 @@ export default class Speaker {
                 continue;
             phonemeIds.push(this.symbolMap[char]);
         }
-        const phonemeIdsPadding = [];
-        for(let i = 0;i < phonemeIds.length * 2;i += 2) {
-            phonemeIdsPadding[i] = 0;
-            phonemeIdsPadding[i + 1] = phonemeIds[Math.ceil(i / 2)];
-        }
-        return new Int16Array(phonemeIdsPadding);
+        // 直接写入Int16Array，原生层原地读取不再拷贝
+        const phonemeIdsPadding = new Int16Array(phonemeIds.length * 2);
+        for(let i = 0;i < phonemeIds.length;i++)
+            phonemeIdsPadding[i * 2 + 1] = phonemeIds[i];
+        return phonemeIdsPadding;
     }
 
     /**
@@ -145,16 +407,27 @@ export default class Speaker {
         return lock.acquire("initialize", async () => {
             if(this.#initialized)
                 return;
-            const { modelPath, modelConfig, numThreads, lengthScale, noiseScale, noiseW, singleSpeaker, audioDeviceName, audioMixerName } = this;
-            const { maxWavValue, sampleRate } = modelConfig;
-            await speaker.initialize(modelPath, {
+            const { modelPath, modelConfig, numThreads, lengthScale, noiseScale, noiseW, singleSpeaker, memoryArena, phonemeBucketSize, maxBatchSize, frontendDictPath, optimizedModelCacheDir, warmup, loudness, decoding, decoderModelPath, audioDeviceName, audioMixerName, playback, placement, cache } = this;
+            const { maxWavValue, sampleRate, symbols } = modelConfig;
+            const pauseIds = PAUSE_SYMBOLS.filter(symbol => !_.isUndefined(this.symbolMap[symbol])).map(symbol => this.symbolMap[symbol]);
+            this.threadPlacement = await this.#native.initialize(modelPath, {
                 maxWavValue,
                 sampleRate,
                 lengthScale,
                 noiseScale,
                 noiseW,
-                singleSpeaker
-            }, numThreads, audioDeviceName, audioMixerName);
+                singleSpeaker,
+                pauseIds,
+                memoryArena,
+                phonemeBucketSize,
+                maxBatchSize,
+                symbols,
+                warmup,
+                ..._.pick(loudness, ["outputGain", "limiterLookahead", "limiterRelease"]),
+                ...(decoderModelPath ? { decoderModelPath, ..._.pickBy({ decodeWindow: decoding.window, decodeContext: decoding.context }, _.isFinite) } : {}),
+                ...(frontendDictPath ? { frontendDictPath } : {}),
+                ...(optimizedModelCacheDir ? { optimizedModelCacheDir } : {})
+            }, numThreads, audioDeviceName, audioMixerName, playback, cache, placement);
             this.#initialized = true;
         });
     }
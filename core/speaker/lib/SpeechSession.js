@@ -0,0 +1,84 @@
+/**
+ * 增量发音会话：上游（如大模型流式回复）逐段追加文本，原生层检测到完整句子即合成并加入发音队列，
+ * 无需等待全文生成，首句在其结束标点到达后即开始播放
+ */
+export default class SpeechSession {
+
+    #native;
+    #done;
+    /** @type {number} 会话ID */
+    id;
+    /** @type {boolean} 是否已结束追加 */
+    ended = false;
+
+    constructor(native, id, done) {
+        this.#native = native;
+        this.id = id;
+        this.#done = done;
+    }
+
+    /**
+     * 追加文本片段，会话结束后追加被忽略
+     * 
+     * @param {string} fragment - 文本片段
+     * @returns {number} - 本次切出并入队的句数（会话被打断后为0）
+     */
+    appendText(fragment) {
+        if(this.ended || !fragment)
+            return 0;
+        return this.#native.appendText(this.id, fragment);
+    }
+
+    /**
+     * 结束追加：剩余文本作为最后一句入队，各句播放完成、被取消或合成失败后返回
+     * 
+     * @returns {object} - 会话结果，state为completed（播放完成）或cancelled（被取消或被其它语句打断），sentences为入队句数，firstChunkDuration为首次追加文本到首句开始播放的时长（毫秒）
+     */
+    async end() {
+        if(!this.ended) {
+            this.ended = true;
+            this.#native.endText(this.id);
+        }
+        return await this.#result();
+    }
+
+    /**
+     * 取消并结束会话：取消排队与正在播放的各句
+     * 
+     * @returns {number} - 取消的语句数
+     */
+    async cancel() {
+        if(this.ended)
+            return 0;
+        this.ended = true;
+        return await this.#native.cancelText(this.id);
+    }
+
+    /**
+     * 等待会话结束（end或cancel之后）
+     */
+    async wait() {
+        return await this.#result();
+    }
+
+    async #result() {
+        const {
+            id,  // 会话ID
+            state,  // 结束状态
+            sentences,  // 入队句数
+            inferDuration,  // 推理时长
+            audioDuration,  // 音频时长
+            firstChunkDuration  // 首块延迟
+        } = await this.#done;
+        return {
+            id,
+            state,
+            sentences,
+            inferDuration,
+            audioDuration,
+            firstChunkDuration,
+            realTimeFactor: audioDuration > 0 ? Math.floor(inferDuration / audioDuration * 1000) / 1000 : 0
+        }
+    }
+
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SPEAKER_KERNEL_NEON
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SPEAKER_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SPEAKER_KERNEL_SSE2
+#endif
+
+#include "audio_kernel.hpp"
+
+namespace speaker
+{
+
+    static constexpr float INT16_MIN_VALUE = static_cast<float>(std::numeric_limits<int16_t>::min());
+    static constexpr float INT16_MAX_VALUE = static_cast<float>(std::numeric_limits<int16_t>::max());
+
+    // 标量实现，同时处理向量实现的尾部
+    static float peakAbsScalar(const float *data, size_t count, float peak)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            peak = std::max(peak, std::fabs(data[i]));
+        }
+        return peak;
+    }
+
+    static void scaleToInt16Scalar(const float *src, int16_t *dst, size_t count, float scale)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            dst[i] = static_cast<int16_t>(std::clamp(src[i] * scale, INT16_MIN_VALUE, INT16_MAX_VALUE));
+        }
+    }
+
+#if defined(SPEAKER_KERNEL_NEON)
+
+    const char *audioKernelName() { return "neon"; }
+
+    float peakAbs(const float *data, size_t count)
+    {
+        float32x4_t max0 = vdupq_n_f32(0.0f);
+        float32x4_t max1 = vdupq_n_f32(0.0f);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            max0 = vmaxq_f32(max0, vabsq_f32(vld1q_f32(data + i)));
+            max1 = vmaxq_f32(max1, vabsq_f32(vld1q_f32(data + i + 4)));
+        }
+        float peak = vmaxvq_f32(vmaxq_f32(max0, max1));
+        return peakAbsScalar(data + i, count - i, peak);
+    }
+
+    void scaleToInt16(const float *src, int16_t *dst, size_t count, float scale)
+    {
+        const float32x4_t scaleVec = vdupq_n_f32(scale);
+        const float32x4_t minVec = vdupq_n_f32(INT16_MIN_VALUE);
+        const float32x4_t maxVec = vdupq_n_f32(INT16_MAX_VALUE);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            float32x4_t low = vmulq_f32(vld1q_f32(src + i), scaleVec);
+            float32x4_t high = vmulq_f32(vld1q_f32(src + i + 4), scaleVec);
+            low = vminq_f32(vmaxq_f32(low, minVec), maxVec);
+            high = vminq_f32(vmaxq_f32(high, minVec), maxVec);
+            int16x8_t packed = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(low)), vqmovn_s32(vcvtq_s32_f32(high)));
+            vst1q_s16(dst + i, packed);
+        }
+        scaleToInt16Scalar(src + i, dst + i, count - i, scale);
+    }
+
+#elif defined(SPEAKER_KERNEL_AVX2)
+
+    const char *audioKernelName() { return "avx2"; }
+
+    float peakAbs(const float *data, size_t count)
+    {
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 max0 = _mm256_setzero_ps();
+        __m256 max1 = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            max0 = _mm256_max_ps(max0, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+            max1 = _mm256_max_ps(max1, _mm256_and_ps(_mm256_loadu_ps(data + i + 8), absMask));
+        }
+        __m256 max = _mm256_max_ps(max0, max1);
+        __m128 max4 = _mm_max_ps(_mm256_castps256_ps128(max), _mm256_extractf128_ps(max, 1));
+        max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+        max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, 1));
+        return peakAbsScalar(data + i, count - i, _mm_cvtss_f32(max4));
+    }
+
+    void scaleToInt16(const float *src, int16_t *dst, size_t count, float scale)
+    {
+        const __m256 scaleVec = _mm256_set1_ps(scale);
+        const __m256 minVec = _mm256_set1_ps(INT16_MIN_VALUE);
+        const __m256 maxVec = _mm256_set1_ps(INT16_MAX_VALUE);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256 low = _mm256_mul_ps(_mm256_loadu_ps(src + i), scaleVec);
+            __m256 high = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scaleVec);
+            // 先在浮点域钳位，避免cvttps溢出得到0x80000000
+            low = _mm256_min_ps(_mm256_max_ps(low, minVec), maxVec);
+            high = _mm256_min_ps(_mm256_max_ps(high, minVec), maxVec);
+            __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(low), _mm256_cvttps_epi32(high));
+            // packs按128位通道交错，恢复采样顺序
+            packed = _mm256_permute4x64_epi64(packed, 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), packed);
+        }
+        scaleToInt16Scalar(src + i, dst + i, count - i, scale);
+    }
+
+#elif defined(SPEAKER_KERNEL_SSE2)
+
+    const char *audioKernelName() { return "sse2"; }
+
+    float peakAbs(const float *data, size_t count)
+    {
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 max0 = _mm_setzero_ps();
+        __m128 max1 = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            max0 = _mm_max_ps(max0, _mm_and_ps(_mm_loadu_ps(data + i), absMask));
+            max1 = _mm_max_ps(max1, _mm_and_ps(_mm_loadu_ps(data + i + 4), absMask));
+        }
+        __m128 max4 = _mm_max_ps(max0, max1);
+        max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+        max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, 1));
+        return peakAbsScalar(data + i, count - i, _mm_cvtss_f32(max4));
+    }
+
+    void scaleToInt16(const float *src, int16_t *dst, size_t count, float scale)
+    {
+        const __m128 scaleVec = _mm_set1_ps(scale);
+        const __m128 minVec = _mm_set1_ps(INT16_MIN_VALUE);
+        const __m128 maxVec = _mm_set1_ps(INT16_MAX_VALUE);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128 low = _mm_mul_ps(_mm_loadu_ps(src + i), scaleVec);
+            __m128 high = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scaleVec);
+            low = _mm_min_ps(_mm_max_ps(low, minVec), maxVec);
+            high = _mm_min_ps(_mm_max_ps(high, minVec), maxVec);
+            __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(low), _mm_cvttps_epi32(high));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), packed);
+        }
+        scaleToInt16Scalar(src + i, dst + i, count - i, scale);
+    }
+
+#else
+
+    const char *audioKernelName() { return "scalar"; }
+
+    float peakAbs(const float *data, size_t count)
+    {
+        return peakAbsScalar(data, count, 0.0f);
+    }
+
+    void scaleToInt16(const float *src, int16_t *dst, size_t count, float scale)
+    {
+        scaleToInt16Scalar(src, dst, count, scale);
+    }
+
+#endif
+
+}
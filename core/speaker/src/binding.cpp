@@ -3,6 +3,9 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <limits>
+#include <mutex>
+#include <condition_variable>
 
 #include <node_api.h>
 #include "speaker.hpp"
@@ -25,6 +28,8 @@ struct PromiseData {
     napi_async_work work;  // NAPI异步任务
     napi_deferred deferred;  // NAPI Promise状态
     void* args;  // 参数指针
+    speaker::Speaker* speaker = nullptr;  // 发音器实例
+    napi_ref speakerRef = nullptr;  // 发音器JS对象引用
 };
 
 /**
@@ -36,6 +41,10 @@ struct InitializeArguments {
     int32_t numThreads;  // 推理线程数
     std::string audioDeviceName;  //音频设备名称
     std::string audioMixerName;  //音频混音器名称
+    speaker::PlaybackConfig playbackConfig;  // 回放配置
+    speaker::CacheConfig cacheConfig;  // 合成缓存配置
+    speaker::PlacementConfig placementConfig;  // 线程放置配置
+    std::string error;  // 初始化异常信息
 };
 
 /**
@@ -46,38 +55,157 @@ struct SetAudioVolumeArguments {
 };
 
 
+/**
+ * 音素输入：Int16Array原地读取，文本由原生文本前端转换
+ */
+struct PhonemeInput {
+    std::string text;  // 文本（非空时由原生文本前端转换为音素）
+    std::vector<int64_t> phonemeIds;  // 文本转换得到的音素数组
+    speaker::PhonemeIdsView view;  // 音素视图（直接引用JS侧Int16Array内存）
+    napi_ref arrayRef = nullptr;  // 异步任务完成前持有Int16Array引用避免被回收
+};
+
 /**
  * synthesize参数
  */
 struct SynthesizeArguments {
-    std::vector<int64_t> *phonemeIds;  // 音素数组
+    PhonemeInput input;  // 音素输入
     int speakerId;  // 音色ID
     double speechRate;  // 语速
     std::vector<int16_t> audioBuffer;  // 音频数据
     speaker::SynthesisResult result;  // 合成结果
-    ~SynthesizeArguments() {
-        if (phonemeIds != nullptr) {
-            delete phonemeIds;
-        }
-    }  // 析构
+};
+
+/**
+ * synthesizeBatch参数
+ */
+struct SynthesizeBatchArguments {
+    std::vector<PhonemeInput> inputs;  // 各句音素输入
+    int speakerId;  // 音色ID
+    double speechRate;  // 语速
+    std::vector<std::vector<int16_t>> audioBuffers;  // 各句音频数据
+    speaker::SynthesisResult result;  // 合成结果
+    std::string error;  // 合成异常信息
+};
+
+/**
+ * synthesizeStream流控状态：已推送但未被JS确认的分块数达到上限时合成线程等待（背压）
+ */
+struct StreamControl {
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t pending = 0;  // 已推送未确认的分块数
+    uint32_t highWaterMark = 2;  // 未确认分块数上限
+    bool cancelled = false;  // JS侧是否已取消
+};
+
+/**
+ * synthesizeStream参数
+ */
+struct SynthesizeStreamArguments {
+    PhonemeInput input;  // 音素输入
+    int speakerId;  // 音色ID
+    double speechRate;  // 语速
+    napi_threadsafe_function onChunk = nullptr;  // 分块回调
+    StreamControl control;  // 流控状态
+    speaker::SynthesisResult result;  // 合成结果（各块合计）
+    std::string error;  // 合成异常信息
+};
+
+/**
+ * synthesizeStream推送到JS线程的分块
+ */
+struct StreamChunk {
+    std::vector<int16_t> audioBuffer;  // 分块音频数据
+    speaker::SynthesisResult result;  // 分块合成结果
+    StreamControl* control;  // 流控状态
 };
 
 /**
  * say参数
  */
 struct SayArguments {
-    std::vector<int64_t> *phonemeIds;  // 音素数组
+    PhonemeInput input;  // 音素输入
     int speakerId;  // 音色ID
     double speechRate;  // 语速
     speaker::SynthesisResult result;  // 合成结果
     bool block;  // 播放是否阻塞
-    ~SayArguments() {
-        if (phonemeIds != nullptr) {
-            delete phonemeIds;
-        }
-    }  // 析构
+    bool stream;  // 是否分句流式合成播放
+};
+
+/**
+ * speak参数：语句结束时由发音线程经线程安全函数回到JS线程兑现Promise
+ */
+struct SpeakArguments {
+    PhonemeInput input;  // 音素输入
+    int speakerId;  // 音色ID
+    double speechRate;  // 语速
+    int32_t priority;  // 优先级
+    bool interrupt;  // 是否打断当前语句
+    napi_threadsafe_function onDone = nullptr;  // 结束回调
+    uint64_t id;  // 语句ID
+    speaker::UtteranceState state;  // 结束状态
+    speaker::SynthesisResult result;  // 合成结果
+    int gapDuration;  // 与上一句之间的播放停顿
+    std::string error;  // 合成异常信息
+};
+
+/**
+ * cancel参数
+ */
+struct CancelArguments {
+    int32_t maxPriority;  // 取消的最高优先级
+    size_t count;  // 取消的语句数
+};
+
+/**
+ * beginText参数
+ */
+struct TextArguments {
+    int speakerId;  // 音色ID
+    double speechRate;  // 语速
+    int32_t priority;  // 优先级
+    bool interrupt;  // 首句是否打断当前语句
+    napi_threadsafe_function onDone = nullptr;  // 结束回调
+    uint64_t id;  // 会话ID
+    speaker::UtteranceState state;  // 结束状态
+    speaker::SynthesisResult result;  // 各句合计结果
+    size_t sentences;  // 入队句数
+    std::string error;  // 合成异常信息
+};
+
+/**
+ * cancelText参数
+ */
+struct CancelTextArguments {
+    uint64_t id;  // 会话ID
+    size_t count;  // 取消的语句数
 };
 
+/**
+ * 获取this绑定的发音器实例，并在异步任务完成前持有JS对象引用避免被回收
+ */
+static speaker::Speaker* unwrapSpeaker(napi_env env, napi_value thisArg, PromiseData* promiseData)
+{
+    speaker::Speaker* instance = nullptr;
+    ASSERT(napi_unwrap(env, thisArg, (void**)(&instance)))
+    if (instance == nullptr)
+    {
+        throw std::runtime_error("Invalid speaker instance");
+    }
+    promiseData->speaker = instance;
+    ASSERT(napi_create_reference(env, thisArg, 1, &promiseData->speakerRef))
+    return instance;
+}
+
+/**
+ * 释放异步任务持有的发音器引用
+ */
+static void releaseSpeaker(napi_env env, PromiseData* promiseData)
+{
+    ASSERT(napi_delete_reference(env, promiseData->speakerRef))
+}
+
 /**
  * 转换js值为string
  */
@@ -89,6 +217,221 @@ static void parseToString(napi_env env, napi_value value, std::string *result)
     ASSERT(napi_get_value_string_utf8(env, value, &(*result)[0], size + 1, nullptr))
 }
 
+/**
+ * 解析音素输入：Int16Array音素数组（不拷贝，持有引用后在工作线程原地读取）或由原生文本前端处理的文本
+ */
+static bool parseToPhonemeInput(napi_env env, napi_value value, PhonemeInput &input)
+{
+    napi_valuetype valueType;
+    ASSERT(napi_typeof(env, value, &valueType))
+    if (valueType == napi_string)
+    {
+        parseToString(env, value, &input.text);
+        return true;
+    }
+    bool isTypedArray;
+    ASSERT(napi_is_typedarray(env, value, &isTypedArray))
+    if (!isTypedArray)
+    {
+        return false;
+    }
+    napi_typedarray_type type;
+    size_t arrayLength;
+    int16_t* array;
+    ASSERT(napi_get_typedarray_info(env, value, &type, &arrayLength, (void**)(&array), nullptr, nullptr));
+    if (type != napi_int16_array)
+    {
+        return false;
+    }
+    input.view = speaker::PhonemeIdsView(array, arrayLength);
+    ASSERT(napi_create_reference(env, value, 1, &input.arrayRef))
+    return true;
+}
+
+/**
+ * 在工作线程中完成文本到音素的转换
+ */
+static void resolvePhonemeInput(speaker::Speaker* instance, PhonemeInput &input)
+{
+    if (input.text.empty())
+    {
+        return;
+    }
+    instance->textToPhonemeIds(input.text, input.phonemeIds);
+    input.view = speaker::PhonemeIdsView(input.phonemeIds);
+}
+
+/**
+ * 释放音素输入持有的Int16Array引用
+ */
+static void releasePhonemeInput(napi_env env, PhonemeInput &input)
+{
+    if (input.arrayRef != nullptr)
+    {
+        ASSERT(napi_delete_reference(env, input.arrayRef))
+        input.arrayRef = nullptr;
+    }
+}
+
+/**
+ * 释放参数持有的JS引用与线程安全函数（异步任务未能启动时）
+ */
+template <typename Arguments>
+static void releaseArguments(napi_env env, Arguments &args)
+{
+}
+
+static void releaseThreadsafeFunction(napi_threadsafe_function &function)
+{
+    if (function != nullptr)
+    {
+        napi_release_threadsafe_function(function, napi_tsfn_release);
+        function = nullptr;
+    }
+}
+
+static void releaseArguments(napi_env env, SynthesizeArguments &args)
+{
+    releasePhonemeInput(env, args.input);
+}
+
+static void releaseArguments(napi_env env, SynthesizeBatchArguments &args)
+{
+    for (PhonemeInput &input : args.inputs)
+    {
+        releasePhonemeInput(env, input);
+    }
+}
+
+static void releaseArguments(napi_env env, SynthesizeStreamArguments &args)
+{
+    releasePhonemeInput(env, args.input);
+    releaseThreadsafeFunction(args.onChunk);
+}
+
+static void releaseArguments(napi_env env, SayArguments &args)
+{
+    releasePhonemeInput(env, args.input);
+}
+
+static void releaseArguments(napi_env env, SpeakArguments &args)
+{
+    releasePhonemeInput(env, args.input);
+    releaseThreadsafeFunction(args.onDone);
+}
+
+static void releaseArguments(napi_env env, TextArguments &args)
+{
+    releaseThreadsafeFunction(args.onDone);
+}
+
+/**
+ * Promise数据的作用域所有者：同步阶段抛出异常时释放参数、发音器引用与Promise数据，
+ * 异步任务排队（或语句入队）后调用release移交给完成回调
+ */
+template <typename Arguments>
+class PromiseGuard {
+public:
+    PromiseGuard(napi_env env, PromiseData* promiseData) : env(env), promiseData(promiseData) {}
+
+    ~PromiseGuard()
+    {
+        if (promiseData == nullptr)
+        {
+            return;
+        }
+        Arguments* args = (Arguments*)promiseData->args;
+        releaseArguments(env, *args);
+        if (promiseData->speakerRef != nullptr)
+        {
+            releaseSpeaker(env, promiseData);
+        }
+        delete args;
+        delete promiseData;
+    }
+
+    PromiseGuard(const PromiseGuard&) = delete;
+    PromiseGuard& operator=(const PromiseGuard&) = delete;
+
+    void release()
+    {
+        promiseData = nullptr;
+    }
+
+private:
+    napi_env env;
+    PromiseData* promiseData;
+};
+
+/**
+ * 读取可选的数值属性
+ */
+static bool getOptionalDouble(napi_env env, napi_value object, const char *name, double &value)
+{
+    bool hasProperty;
+    ASSERT(napi_has_named_property(env, object, name, &hasProperty))
+    if (!hasProperty)
+    {
+        return false;
+    }
+    napi_value property;
+    napi_valuetype valueType;
+    ASSERT(napi_get_named_property(env, object, name, &property))
+    ASSERT(napi_typeof(env, property, &valueType))
+    if (valueType != napi_number)
+    {
+        return false;
+    }
+    ASSERT(napi_get_value_double(env, property, &value))
+    return true;
+}
+
+/**
+ * 读取可选的布尔属性
+ */
+static bool getOptionalBool(napi_env env, napi_value object, const char *name, bool &value)
+{
+    bool hasProperty;
+    ASSERT(napi_has_named_property(env, object, name, &hasProperty))
+    if (!hasProperty)
+    {
+        return false;
+    }
+    napi_value property;
+    napi_valuetype valueType;
+    ASSERT(napi_get_named_property(env, object, name, &property))
+    ASSERT(napi_typeof(env, property, &valueType))
+    if (valueType != napi_boolean)
+    {
+        return false;
+    }
+    ASSERT(napi_get_value_bool(env, property, &value))
+    return true;
+}
+
+/**
+ * 读取可选的字符串属性
+ */
+static bool getOptionalString(napi_env env, napi_value object, const char *name, std::string &value)
+{
+    bool hasProperty;
+    ASSERT(napi_has_named_property(env, object, name, &hasProperty))
+    if (!hasProperty)
+    {
+        return false;
+    }
+    napi_value property;
+    napi_valuetype valueType;
+    ASSERT(napi_get_named_property(env, object, name, &property))
+    ASSERT(napi_typeof(env, property, &valueType))
+    if (valueType != napi_string)
+    {
+        return false;
+    }
+    parseToString(env, property, &value);
+    return true;
+}
+
 /**
  * 解析模型配置
  */
@@ -131,6 +474,187 @@ static void parseToModelConfig(napi_env env, napi_value value, speaker::ModelCon
     modelConfig.noiseW = static_cast<float>(noiseW);
     ASSERT(napi_get_value_bool(env, _singleSpeaker, &singleSpeaker))
     modelConfig.singleSpeaker = singleSpeaker;
+
+    // 停顿符号ID为可选项
+    bool hasPauseIds;
+    ASSERT(napi_has_named_property(env, value, "pauseIds", &hasPauseIds))
+    if (hasPauseIds)
+    {
+        napi_value _pauseIds;
+        ASSERT(napi_get_named_property(env, value, "pauseIds", &_pauseIds))
+        bool isArray;
+        ASSERT(napi_is_array(env, _pauseIds, &isArray))
+        if (isArray)
+        {
+            uint32_t length;
+            ASSERT(napi_get_array_length(env, _pauseIds, &length))
+            modelConfig.pauseIds.resize(length);
+            for (uint32_t i = 0; i < length; i++)
+            {
+                napi_value element;
+                int32_t pauseId;
+                ASSERT(napi_get_element(env, _pauseIds, i, &element))
+                ASSERT(napi_get_value_int32(env, element, &pauseId))
+                modelConfig.pauseIds[i] = pauseId;
+            }
+        }
+    }
+
+    // 推理内存选项为可选项
+    getOptionalBool(env, value, "memoryArena", modelConfig.memoryArena);
+    double phonemeBucketSize;
+    if (getOptionalDouble(env, value, "phonemeBucketSize", phonemeBucketSize))
+        modelConfig.phonemeBucketSize = static_cast<uint32_t>(phonemeBucketSize);
+    double maxBatchSize;
+    if (getOptionalDouble(env, value, "maxBatchSize", maxBatchSize))
+        modelConfig.maxBatchSize = static_cast<uint32_t>(maxBatchSize);
+
+    // 原生文本前端为可选项，需同时提供模型符号表与词典路径
+    bool hasSymbols;
+    ASSERT(napi_has_named_property(env, value, "symbols", &hasSymbols))
+    if (hasSymbols)
+    {
+        napi_value _symbols;
+        ASSERT(napi_get_named_property(env, value, "symbols", &_symbols))
+        bool isArray;
+        ASSERT(napi_is_array(env, _symbols, &isArray))
+        if (isArray)
+        {
+            uint32_t length;
+            ASSERT(napi_get_array_length(env, _symbols, &length))
+            modelConfig.symbols.resize(length);
+            for (uint32_t i = 0; i < length; i++)
+            {
+                napi_value element;
+                ASSERT(napi_get_element(env, _symbols, i, &element))
+                parseToString(env, element, &modelConfig.symbols[i]);
+            }
+        }
+    }
+    getOptionalString(env, value, "frontendDictPath", modelConfig.frontendDictPath);
+
+    // 优化模型缓存与预热为可选项
+    getOptionalString(env, value, "optimizedModelCacheDir", modelConfig.optimizedModelCacheDir);
+    getOptionalBool(env, value, "warmup", modelConfig.warmup);
+
+    // 响度配置为可选项，未设置输出增益时逐段峰值归一化
+    double loudnessValue;
+    if (getOptionalDouble(env, value, "outputGain", loudnessValue))
+        modelConfig.outputGain = static_cast<float>(loudnessValue);
+    if (getOptionalDouble(env, value, "limiterLookahead", loudnessValue))
+        modelConfig.limiterLookahead = static_cast<uint32_t>(loudnessValue);
+    if (getOptionalDouble(env, value, "limiterRelease", loudnessValue))
+        modelConfig.limiterRelease = static_cast<uint32_t>(loudnessValue);
+
+    // 拆分模型为可选项，设置流与声码器模型路径后按窗口增量解码
+    getOptionalString(env, value, "decoderModelPath", modelConfig.decoderModelPath);
+    double decodeValue;
+    if (getOptionalDouble(env, value, "decodeWindow", decodeValue))
+        modelConfig.decodeWindow = static_cast<uint32_t>(decodeValue);
+    if (getOptionalDouble(env, value, "decodeContext", decodeValue))
+        modelConfig.decodeContext = static_cast<uint32_t>(decodeValue);
+}
+
+/**
+ * 解析回放配置
+ */
+static void parseToPlaybackConfig(napi_env env, napi_value value, speaker::PlaybackConfig &playbackConfig)
+{
+    napi_valuetype valueType;
+    ASSERT(napi_typeof(env, value, &valueType));
+    if(valueType != napi_object)
+    {
+        return;
+    }
+    double number;
+    if (getOptionalDouble(env, value, "periodSize", number))
+        playbackConfig.periodSize = static_cast<uint32_t>(number);
+    if (getOptionalDouble(env, value, "bufferSize", number))
+        playbackConfig.bufferSize = static_cast<uint32_t>(number);
+    if (getOptionalDouble(env, value, "ringBufferDuration", number))
+        playbackConfig.ringBufferDuration = static_cast<uint32_t>(number);
+    if (getOptionalDouble(env, value, "queueLength", number))
+        playbackConfig.queueLength = static_cast<uint32_t>(number);
+    if (getOptionalDouble(env, value, "lookaheadDuration", number))
+        playbackConfig.lookaheadDuration = static_cast<uint32_t>(number);
+    if (getOptionalDouble(env, value, "idleTimeout", number))
+        playbackConfig.idleTimeout = static_cast<uint32_t>(number);
+    getOptionalBool(env, value, "realtime", playbackConfig.realtime);
+}
+
+/**
+ * 解析合成缓存配置
+ */
+static void parseToCacheConfig(napi_env env, napi_value value, speaker::CacheConfig &cacheConfig)
+{
+    napi_valuetype valueType;
+    ASSERT(napi_typeof(env, value, &valueType));
+    if(valueType != napi_object)
+    {
+        return;
+    }
+    double number;
+    if (getOptionalDouble(env, value, "memoryCapacity", number))
+        cacheConfig.memoryCapacity = static_cast<uint32_t>(number);
+    if (getOptionalDouble(env, value, "fileCapacity", number))
+        cacheConfig.fileCapacity = static_cast<uint32_t>(number);
+    bool hasFilePath;
+    ASSERT(napi_has_named_property(env, value, "filePath", &hasFilePath))
+    if (hasFilePath)
+    {
+        napi_value filePath;
+        ASSERT(napi_get_named_property(env, value, "filePath", &filePath))
+        ASSERT(napi_typeof(env, filePath, &valueType))
+        if (valueType == napi_string)
+        {
+            parseToString(env, filePath, &cacheConfig.filePath);
+        }
+    }
+}
+
+/**
+ * 解析线程放置配置
+ */
+static void parseToPlacementConfig(napi_env env, napi_value value, speaker::PlacementConfig &placementConfig)
+{
+    napi_valuetype valueType;
+    ASSERT(napi_typeof(env, value, &valueType));
+    if(valueType != napi_object)
+    {
+        return;
+    }
+    getOptionalBool(env, value, "pinAudio", placementConfig.pinAudio);
+    double sessions;
+    if (getOptionalDouble(env, value, "sessions", sessions))
+        placementConfig.sessions = static_cast<uint16_t>(sessions < 1 ? 1 : sessions);
+    bool hasInferenceCluster;
+    ASSERT(napi_has_named_property(env, value, "inferenceCluster", &hasInferenceCluster))
+    if (hasInferenceCluster)
+    {
+        napi_value inferenceCluster;
+        ASSERT(napi_get_named_property(env, value, "inferenceCluster", &inferenceCluster))
+        ASSERT(napi_typeof(env, inferenceCluster, &valueType))
+        if (valueType == napi_string)
+        {
+            parseToString(env, inferenceCluster, &placementConfig.inferenceCluster);
+        }
+    }
+}
+
+/**
+ * 创建核心编号数组
+ */
+static napi_value createCpuArray(napi_env env, const std::vector<int> &cpus)
+{
+    napi_value array;
+    ASSERT(napi_create_array_with_length(env, cpus.size(), &array));
+    for (size_t i = 0; i < cpus.size(); i++)
+    {
+        napi_value cpu;
+        ASSERT(napi_create_int32(env, cpus[i], &cpu));
+        ASSERT(napi_set_element(env, array, i, cpu));
+    }
+    return array;
 }
 
 /**
@@ -141,9 +665,10 @@ static napi_value initializeWrapper(napi_env env, napi_callback_info info)
     napi_value promise;
     try
     {
-        size_t argc = 5;
-        napi_value argv[5];
-        ASSERT(napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
+        size_t argc = 8;
+        napi_value argv[8];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
         if (argc < 5)
         {
             ASSERT(napi_throw_error(env, "101", "Invalid arguments"));
@@ -152,12 +677,26 @@ static napi_value initializeWrapper(napi_env env, napi_callback_info info)
         InitializeArguments* args = new InitializeArguments();
         PromiseData* promiseData =  new PromiseData();
         promiseData->args = args;
+        PromiseGuard<InitializeArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
 
         parseToString(env, argv[0], &args->modelPath);
         parseToModelConfig(env, argv[1], args->modelConfig);
         ASSERT(napi_get_value_int32(env, argv[2], &args->numThreads))
         parseToString(env, argv[3], &args->audioDeviceName);
         parseToString(env, argv[4], &args->audioMixerName);
+        if (argc > 5)
+        {
+            parseToPlaybackConfig(env, argv[5], args->playbackConfig);
+        }
+        if (argc > 6)
+        {
+            parseToCacheConfig(env, argv[6], args->cacheConfig);
+        }
+        if (argc > 7)
+        {
+            parseToPlacementConfig(env, argv[7], args->placementConfig);
+        }
 
         ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
 
@@ -167,27 +706,56 @@ static napi_value initializeWrapper(napi_env env, napi_callback_info info)
             [](napi_env env, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
                 InitializeArguments* args = (InitializeArguments*)promiseData->args;
-                speaker::initialize(
-                    args->modelPath,
-                    args->modelConfig,
-                    static_cast<uint16_t>(args->numThreads),
-                    args->audioDeviceName,
-                    args->audioMixerName
-                );
+                // 工作线程中的异常无法传播，记录后在完成回调中拒绝
+                try
+                {
+                    promiseData->speaker->initialize(
+                        args->modelPath,
+                        args->modelConfig,
+                        static_cast<uint16_t>(args->numThreads),
+                        args->audioDeviceName,
+                        args->audioMixerName,
+                        args->playbackConfig,
+                        args->cacheConfig,
+                        args->placementConfig
+                    );
+                }
+                catch (const std::exception& e)
+                {
+                    args->error = e.what();
+                }
             },
             [](napi_env env, napi_status status, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
-                napi_value result;
-                ASSERT(napi_get_undefined(env, &result))
-                ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
+                InitializeArguments* args = (InitializeArguments*)promiseData->args;
+                if (!args->error.empty())
+                {
+                    napi_value errorMsg;
+                    ASSERT(napi_create_string_utf8(env, args->error.c_str(), NAPI_AUTO_LENGTH, &errorMsg));
+                    ASSERT(napi_reject_deferred(env, static_cast<napi_deferred>(promiseData->deferred), errorMsg));
+                }
+                else
+                {
+                    // 返回线程放置结果
+                    const speaker::ThreadPlacement &placement = promiseData->speaker->getPlacement();
+                    napi_value result, description;
+                    ASSERT(napi_create_object(env, &result))
+                    ASSERT(napi_set_named_property(env, result, "inferenceCpus", createCpuArray(env, placement.inferenceCpus)))
+                    ASSERT(napi_set_named_property(env, result, "audioCpus", createCpuArray(env, placement.audioCpus)))
+                    ASSERT(napi_create_string_utf8(env, placement.describe().c_str(), NAPI_AUTO_LENGTH, &description))
+                    ASSERT(napi_set_named_property(env, result, "description", description))
+                    ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
+                }
                 ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
-                delete (InitializeArguments*)promiseData->args;
+                releaseSpeaker(env, promiseData);
+                delete args;
                 delete promiseData;
             },
             promiseData, &(promiseData->work)
         ))
         
         ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
         return promise;
     }
     catch (const std::exception& e)
@@ -211,7 +779,8 @@ static napi_value setVolumeWrapper(napi_env env, napi_callback_info info)
     {
         size_t argc = 1;
         napi_value argv[1];
-        ASSERT(napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
         if (argc < 1)
         {
             ASSERT(napi_throw_error(env, "101", "Invalid arguments"));
@@ -220,6 +789,8 @@ static napi_value setVolumeWrapper(napi_env env, napi_callback_info info)
         SetAudioVolumeArguments* args = new SetAudioVolumeArguments();
         PromiseData* promiseData =  new PromiseData();
         promiseData->args = args;
+        PromiseGuard<SetAudioVolumeArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
 
         ASSERT(napi_get_value_int32(env, argv[0], &args->volume))
 
@@ -231,7 +802,7 @@ static napi_value setVolumeWrapper(napi_env env, napi_callback_info info)
             [](napi_env env, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
                 SetAudioVolumeArguments* args = (SetAudioVolumeArguments*)promiseData->args;
-                speaker::setVolume(
+                promiseData->speaker->setVolume(
                     args->volume
                 );
             },
@@ -241,6 +812,7 @@ static napi_value setVolumeWrapper(napi_env env, napi_callback_info info)
                 ASSERT(napi_get_undefined(env, &result))
                 ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
                 ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
                 delete (SetAudioVolumeArguments*)promiseData->args;
                 delete promiseData;
             },
@@ -248,6 +820,7 @@ static napi_value setVolumeWrapper(napi_env env, napi_callback_info info)
         ))
         
         ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
         return promise;
     }
     catch (const std::exception& e)
@@ -261,6 +834,52 @@ static napi_value setVolumeWrapper(napi_env env, napi_callback_info info)
     }
 }
 
+/**
+ * 创建Int16Array并移交音频数据所有权：外部ArrayBuffer直接引用原生缓冲区，由GC回收时释放，不再拷贝
+ * 运行时禁止外部ArrayBuffer时回退为拷贝
+ */
+static napi_value createInt16Array(napi_env env, std::vector<int16_t> &&audioBuffer)
+{
+    size_t length = audioBuffer.size();
+    size_t byteLength = length * sizeof(int16_t);
+    napi_value arrayBuffer = nullptr;
+    if (length > 0)
+    {
+        std::vector<int16_t>* buffer = new std::vector<int16_t>(std::move(audioBuffer));
+        napi_status status = napi_create_external_arraybuffer(env, buffer->data(), byteLength,
+            [](napi_env env, void* data, void* hint) {
+                std::vector<int16_t>* buffer = (std::vector<int16_t>*)hint;
+                int64_t adjustedValue;
+                napi_adjust_external_memory(env, -(int64_t)(buffer->size() * sizeof(int16_t)), &adjustedValue);
+                delete buffer;
+            },
+            buffer, &arrayBuffer);
+        if (status == napi_ok)
+        {
+            int64_t adjustedValue;
+            ASSERT(napi_adjust_external_memory(env, (int64_t)byteLength, &adjustedValue))
+        }
+        else
+        {
+            audioBuffer = std::move(*buffer);
+            delete buffer;
+            arrayBuffer = nullptr;
+        }
+    }
+    if (arrayBuffer == nullptr)
+    {
+        void* tempData;
+        ASSERT(napi_create_arraybuffer(env, byteLength, &tempData, &arrayBuffer));
+        if (byteLength > 0)
+        {
+            memcpy(tempData, audioBuffer.data(), byteLength);
+        }
+    }
+    napi_value array;
+    ASSERT(napi_create_typedarray(env, napi_int16_array, length, arrayBuffer, 0, &array));
+    return array;
+}
+
 /**
  * synthesize函数包装
  */
@@ -271,10 +890,9 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
     {
         size_t argc = 3;
         napi_value argv[3];
-        ASSERT(napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
-        bool isTypedArray;
-        napi_is_typedarray(env, argv[0], &isTypedArray);
-        if (argc < 3 || !isTypedArray)
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 3)
         {
             ASSERT(napi_throw_error(env, "101", "Invalid arguments"));
         }
@@ -282,16 +900,17 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
         SynthesizeArguments* args = new SynthesizeArguments();
         PromiseData* promiseData = new PromiseData();
         promiseData->args = args;
+        PromiseGuard<SynthesizeArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
 
-        napi_typedarray_type type;
-        size_t arrayLength;
-        int16_t* array;
-        ASSERT(napi_get_typedarray_info(env, argv[0], nullptr, &arrayLength, (void**)(&array), nullptr, nullptr));
-        std::vector<int64_t>* phonemeIds = new std::vector<int64_t>(arrayLength);
-        for (uint32_t i = 0; i < arrayLength; ++i) {
-            (*phonemeIds)[i] = static_cast<int64_t>(array[i]);
+        if (!parseToPhonemeInput(env, argv[0], args->input))
+        {
+            throw std::runtime_error("Invalid phoneme ids or text");
+        }
+        if (!args->input.text.empty() && !promiseData->speaker->hasTextFrontend())
+        {
+            throw std::runtime_error("Text frontend dictionary not loaded");
         }
-        args->phonemeIds = phonemeIds;
         ASSERT(napi_get_value_int32(env, argv[1], &args->speakerId))
         ASSERT(napi_get_value_double(env, argv[2], &args->speechRate))
 
@@ -303,8 +922,9 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
             [](napi_env env, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
                 SynthesizeArguments* args = (SynthesizeArguments*)promiseData->args;
-                speaker::synthesize(
-                    *(args->phonemeIds),
+                resolvePhonemeInput(promiseData->speaker, args->input);
+                promiseData->speaker->synthesize(
+                    args->input.view,
                     static_cast<uint16_t>(args->speakerId),
                     static_cast<float>(args->speechRate),
                     args->audioBuffer,
@@ -314,14 +934,8 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
             [](napi_env env, napi_status status, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
                 SynthesizeArguments* args = (SynthesizeArguments*)promiseData->args;
-                int16_t* buffer = args->audioBuffer.data();
-                int bufferLength = args->audioBuffer.size();
-                void* tempData;
-                napi_value arrayBuffer;
-                ASSERT(napi_create_arraybuffer(env, bufferLength * sizeof(int16_t), &tempData, &arrayBuffer));
-                memcpy(tempData, buffer, bufferLength * sizeof(int16_t));
-                napi_value array;
-                ASSERT(napi_create_typedarray(env, napi_int16_array, bufferLength, arrayBuffer, 0, &array));
+                releasePhonemeInput(env, args->input);
+                napi_value array = createInt16Array(env, std::move(args->audioBuffer));
                 napi_value result;
                 ASSERT(napi_create_object(env, &result));
                 ASSERT(napi_set_named_property(env, result, "data", array));
@@ -330,8 +944,12 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
                 ASSERT(napi_create_int32(env, args->result.audioDuration, &audioDuration));
                 ASSERT(napi_set_named_property(env, result, "inferDuration", inferDuration));
                 ASSERT(napi_set_named_property(env, result, "audioDuration", audioDuration));
+                napi_value firstChunkDuration;
+                ASSERT(napi_create_int32(env, args->result.firstChunkDuration, &firstChunkDuration));
+                ASSERT(napi_set_named_property(env, result, "firstChunkDuration", firstChunkDuration));
                 ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
                 ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
                 delete args;
                 delete promiseData;
             },
@@ -339,6 +957,7 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
         ))
         
         ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
         return promise;
     }
     catch (const std::exception& e)
@@ -353,19 +972,382 @@ static napi_value synthesizeWrapper(napi_env env, napi_callback_info info)
 }
 
 /**
- * say函数包装
+ * synthesizeBatch函数包装
  */
-static napi_value sayWrapper(napi_env env, napi_callback_info info)
+static napi_value synthesizeBatchWrapper(napi_env env, napi_callback_info info)
 {
     napi_value promise;
     try
     {
-        size_t argc = 4;
-        napi_value argv[4];
-        ASSERT(napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr))
-        bool isTypedArray;
-        napi_is_typedarray(env, argv[0], &isTypedArray);
-        if (argc < 4 || !isTypedArray)
+        size_t argc = 3;
+        napi_value argv[3];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        bool isArray;
+        napi_is_array(env, argv[0], &isArray);
+        if (argc < 3 || !isArray)
+        {
+            ASSERT(napi_throw_error(env, "101", "Invalid arguments"));
+        }
+
+        SynthesizeBatchArguments* args = new SynthesizeBatchArguments();
+        PromiseData* promiseData = new PromiseData();
+        promiseData->args = args;
+        PromiseGuard<SynthesizeBatchArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
+
+        uint32_t batchSize;
+        ASSERT(napi_get_array_length(env, argv[0], &batchSize))
+        args->inputs.resize(batchSize);
+        for (uint32_t i = 0; i < batchSize; i++) {
+            napi_value element;
+            ASSERT(napi_get_element(env, argv[0], i, &element))
+            if (!parseToPhonemeInput(env, element, args->inputs[i]))
+            {
+                throw std::runtime_error("Invalid phoneme ids or text");
+            }
+            if (!args->inputs[i].text.empty() && !promiseData->speaker->hasTextFrontend())
+            {
+                throw std::runtime_error("Text frontend dictionary not loaded");
+            }
+        }
+        ASSERT(napi_get_value_int32(env, argv[1], &args->speakerId))
+        ASSERT(napi_get_value_double(env, argv[2], &args->speechRate))
+
+        ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
+
+        napi_value workName;
+        ASSERT(napi_create_string_utf8(env, "synthesizeBatch", NAPI_AUTO_LENGTH, &workName))
+        ASSERT(napi_create_async_work(env, nullptr, workName, 
+            [](napi_env env, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                SynthesizeBatchArguments* args = (SynthesizeBatchArguments*)promiseData->args;
+                try
+                {
+                    std::vector<speaker::PhonemeIdsView> phonemeIdsBatch(args->inputs.size());
+                    for (size_t i = 0; i < args->inputs.size(); i++) {
+                        resolvePhonemeInput(promiseData->speaker, args->inputs[i]);
+                        phonemeIdsBatch[i] = args->inputs[i].view;
+                    }
+                    promiseData->speaker->synthesizeBatch(
+                        phonemeIdsBatch,
+                        static_cast<uint16_t>(args->speakerId),
+                        static_cast<float>(args->speechRate),
+                        args->audioBuffers,
+                        args->result
+                    );
+                }
+                catch (const std::exception& e)
+                {
+                    args->error = e.what();
+                }
+            },
+            [](napi_env env, napi_status status, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                SynthesizeBatchArguments* args = (SynthesizeBatchArguments*)promiseData->args;
+                for (PhonemeInput &input : args->inputs) {
+                    releasePhonemeInput(env, input);
+                }
+                if (!args->error.empty())
+                {
+                    napi_value errorMsg;
+                    ASSERT(napi_create_string_utf8(env, args->error.c_str(), NAPI_AUTO_LENGTH, &errorMsg));
+                    ASSERT(napi_reject_deferred(env, static_cast<napi_deferred>(promiseData->deferred), errorMsg));
+                }
+                else
+                {
+                    napi_value dataArray;
+                    ASSERT(napi_create_array_with_length(env, args->audioBuffers.size(), &dataArray));
+                    for (size_t i = 0; i < args->audioBuffers.size(); i++) {
+                        ASSERT(napi_set_element(env, dataArray, i, createInt16Array(env, std::move(args->audioBuffers[i]))));
+                    }
+                    napi_value result;
+                    ASSERT(napi_create_object(env, &result));
+                    ASSERT(napi_set_named_property(env, result, "data", dataArray));
+                    napi_value inferDuration, audioDuration;
+                    ASSERT(napi_create_int32(env, args->result.inferDuration, &inferDuration));
+                    ASSERT(napi_create_int32(env, args->result.audioDuration, &audioDuration));
+                    ASSERT(napi_set_named_property(env, result, "inferDuration", inferDuration));
+                    ASSERT(napi_set_named_property(env, result, "audioDuration", audioDuration));
+                    ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
+                }
+                ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
+                delete args;
+                delete promiseData;
+            },
+            promiseData, &(promiseData->work)
+        ))
+        
+        ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
+        return promise;
+    }
+    catch (const std::exception& e)
+    {
+        napi_value errorMsg;
+        ASSERT(napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &errorMsg))
+        napi_deferred deferred;
+        ASSERT(napi_create_promise(env, &deferred, &promise))
+        ASSERT(napi_reject_deferred(env, deferred, errorMsg))
+        return promise;
+    }
+}
+
+/**
+ * 确认一个分块已被JS消费，proceed为false时取消后续合成
+ */
+static void settleStreamChunk(StreamControl* control, bool proceed)
+{
+    std::lock_guard<std::mutex> lock(control->mutex);
+    control->pending--;
+    if (!proceed)
+    {
+        control->cancelled = true;
+    }
+    control->condition.notify_all();
+}
+
+/**
+ * 分块回调返回的Promise兑现：值为false时取消合成
+ */
+static napi_value streamAckWrapper(napi_env env, napi_callback_info info)
+{
+    size_t argc = 1;
+    napi_value argv[1];
+    void* data;
+    ASSERT(napi_get_cb_info(env, info, &argc, argv, nullptr, &data))
+    bool proceed = true;
+    napi_valuetype valueType = napi_undefined;
+    if (argc > 0)
+    {
+        ASSERT(napi_typeof(env, argv[0], &valueType))
+    }
+    if (valueType == napi_boolean)
+    {
+        ASSERT(napi_get_value_bool(env, argv[0], &proceed))
+    }
+    settleStreamChunk((StreamControl*)data, proceed);
+    return nullptr;
+}
+
+/**
+ * 分块回调返回的Promise拒绝：取消合成
+ */
+static napi_value streamCancelWrapper(napi_env env, napi_callback_info info)
+{
+    void* data;
+    ASSERT(napi_get_cb_info(env, info, nullptr, nullptr, nullptr, &data))
+    settleStreamChunk((StreamControl*)data, false);
+    return nullptr;
+}
+
+/**
+ * 在JS线程中调用分块回调：回调返回Promise时待其兑现后再确认分块，实现背压
+ */
+static void callStreamChunk(napi_env env, napi_value jsCallback, void* context, void* data)
+{
+    StreamChunk* chunk = (StreamChunk*)data;
+    StreamControl* control = chunk->control;
+    if (env == nullptr)
+    {
+        delete chunk;
+        settleStreamChunk(control, false);
+        return;
+    }
+    napi_value argv[2];
+    argv[0] = createInt16Array(env, std::move(chunk->audioBuffer));
+    ASSERT(napi_create_object(env, &argv[1]));
+    napi_value inferDuration, audioDuration;
+    ASSERT(napi_create_int32(env, chunk->result.inferDuration, &inferDuration));
+    ASSERT(napi_create_int32(env, chunk->result.audioDuration, &audioDuration));
+    ASSERT(napi_set_named_property(env, argv[1], "inferDuration", inferDuration));
+    ASSERT(napi_set_named_property(env, argv[1], "audioDuration", audioDuration));
+    delete chunk;
+
+    napi_value undefined, returnValue;
+    ASSERT(napi_get_undefined(env, &undefined));
+    if (napi_call_function(env, undefined, jsCallback, 2, argv, &returnValue) != napi_ok)
+    {
+        // 回调抛出异常时取消合成
+        napi_value exception;
+        napi_get_and_clear_last_exception(env, &exception);
+        settleStreamChunk(control, false);
+        return;
+    }
+    bool isPromise;
+    ASSERT(napi_is_promise(env, returnValue, &isPromise));
+    if (!isPromise)
+    {
+        bool proceed = true;
+        napi_valuetype valueType;
+        ASSERT(napi_typeof(env, returnValue, &valueType));
+        if (valueType == napi_boolean)
+        {
+            ASSERT(napi_get_value_bool(env, returnValue, &proceed));
+        }
+        settleStreamChunk(control, proceed);
+        return;
+    }
+    napi_value thenFunction, thenArgs[2];
+    ASSERT(napi_get_named_property(env, returnValue, "then", &thenFunction));
+    ASSERT(napi_create_function(env, "ack", NAPI_AUTO_LENGTH, streamAckWrapper, control, &thenArgs[0]));
+    ASSERT(napi_create_function(env, "cancel", NAPI_AUTO_LENGTH, streamCancelWrapper, control, &thenArgs[1]));
+    ASSERT(napi_call_function(env, returnValue, thenFunction, 2, thenArgs, nullptr));
+}
+
+/**
+ * synthesizeStream函数包装
+ */
+static napi_value synthesizeStreamWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value promise;
+    try
+    {
+        size_t argc = 5;
+        napi_value argv[5];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        napi_valuetype callbackType = napi_undefined;
+        if (argc == 5)
+        {
+            ASSERT(napi_typeof(env, argv[4], &callbackType))
+        }
+        if (callbackType != napi_function)
+        {
+            throw std::runtime_error("Invalid arguments");
+        }
+
+        SynthesizeStreamArguments* args = new SynthesizeStreamArguments();
+        PromiseData* promiseData = new PromiseData();
+        promiseData->args = args;
+        PromiseGuard<SynthesizeStreamArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
+
+        if (!parseToPhonemeInput(env, argv[0], args->input))
+        {
+            throw std::runtime_error("Invalid phoneme ids or text");
+        }
+        if (!args->input.text.empty() && !promiseData->speaker->hasTextFrontend())
+        {
+            throw std::runtime_error("Text frontend dictionary not loaded");
+        }
+        ASSERT(napi_get_value_int32(env, argv[1], &args->speakerId))
+        ASSERT(napi_get_value_double(env, argv[2], &args->speechRate))
+        uint32_t highWaterMark;
+        ASSERT(napi_get_value_uint32(env, argv[3], &highWaterMark))
+        args->control.highWaterMark = std::max<uint32_t>(1, highWaterMark);
+
+        ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
+
+        napi_value workName;
+        ASSERT(napi_create_string_utf8(env, "synthesizeStream", NAPI_AUTO_LENGTH, &workName))
+        ASSERT(napi_create_threadsafe_function(env, argv[4], nullptr, workName, 0, 1,
+            nullptr, nullptr, nullptr, callStreamChunk, &args->onChunk))
+        ASSERT(napi_create_async_work(env, nullptr, workName, 
+            [](napi_env env, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                SynthesizeStreamArguments* args = (SynthesizeStreamArguments*)promiseData->args;
+                StreamControl &control = args->control;
+                try
+                {
+                    resolvePhonemeInput(promiseData->speaker, args->input);
+                    promiseData->speaker->synthesizeStream(
+                        args->input.view,
+                        static_cast<uint16_t>(args->speakerId),
+                        static_cast<float>(args->speechRate),
+                        [args, &control](std::vector<int16_t> &audioBuffer, const speaker::SynthesisResult &chunkResult) {
+                            {
+                                std::unique_lock<std::mutex> lock(control.mutex);
+                                control.condition.wait(lock, [&control] { return control.cancelled || control.pending < control.highWaterMark; });
+                                if (control.cancelled)
+                                {
+                                    return false;
+                                }
+                                control.pending++;
+                            }
+                            StreamChunk* chunk = new StreamChunk{std::move(audioBuffer), chunkResult, &control};
+                            if (napi_call_threadsafe_function(args->onChunk, chunk, napi_tsfn_blocking) != napi_ok)
+                            {
+                                delete chunk;
+                                settleStreamChunk(&control, false);
+                                return false;
+                            }
+                            return true;
+                        },
+                        args->result
+                    );
+                }
+                catch (const std::exception& e)
+                {
+                    args->error = e.what();
+                }
+                // 等待已推送分块全部确认，确认函数引用的流控状态此后才可释放
+                std::unique_lock<std::mutex> lock(control.mutex);
+                control.condition.wait(lock, [&control] { return control.pending == 0; });
+            },
+            [](napi_env env, napi_status status, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                SynthesizeStreamArguments* args = (SynthesizeStreamArguments*)promiseData->args;
+                ASSERT(napi_release_threadsafe_function(args->onChunk, napi_tsfn_release));
+                releasePhonemeInput(env, args->input);
+                if (!args->error.empty())
+                {
+                    napi_value errorMsg;
+                    ASSERT(napi_create_string_utf8(env, args->error.c_str(), NAPI_AUTO_LENGTH, &errorMsg));
+                    ASSERT(napi_reject_deferred(env, static_cast<napi_deferred>(promiseData->deferred), errorMsg));
+                }
+                else
+                {
+                    napi_value result;
+                    ASSERT(napi_create_object(env, &result));
+                    napi_value inferDuration, audioDuration, firstChunkDuration, cancelled;
+                    ASSERT(napi_create_int32(env, args->result.inferDuration, &inferDuration));
+                    ASSERT(napi_create_int32(env, args->result.audioDuration, &audioDuration));
+                    ASSERT(napi_create_int32(env, args->result.firstChunkDuration, &firstChunkDuration));
+                    ASSERT(napi_get_boolean(env, args->control.cancelled, &cancelled));
+                    ASSERT(napi_set_named_property(env, result, "inferDuration", inferDuration));
+                    ASSERT(napi_set_named_property(env, result, "audioDuration", audioDuration));
+                    ASSERT(napi_set_named_property(env, result, "firstChunkDuration", firstChunkDuration));
+                    ASSERT(napi_set_named_property(env, result, "cancelled", cancelled));
+                    ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
+                }
+                ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
+                delete args;
+                delete promiseData;
+            },
+            promiseData, &(promiseData->work)
+        ))
+        
+        ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
+        return promise;
+    }
+    catch (const std::exception& e)
+    {
+        napi_value errorMsg;
+        ASSERT(napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &errorMsg))
+        napi_deferred deferred;
+        ASSERT(napi_create_promise(env, &deferred, &promise))
+        ASSERT(napi_reject_deferred(env, deferred, errorMsg))
+        return promise;
+    }
+}
+
+/**
+ * say函数包装
+ */
+static napi_value sayWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value promise;
+    try
+    {
+        size_t argc = 5;
+        napi_value argv[5];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 4)
         {
             ASSERT(napi_throw_error(env, "101", "Invalid arguments"));
         }
@@ -373,19 +1355,25 @@ static napi_value sayWrapper(napi_env env, napi_callback_info info)
         SayArguments* args = new SayArguments();
         PromiseData* promiseData = new PromiseData();
         promiseData->args = args;
+        PromiseGuard<SayArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
 
-        napi_typedarray_type type;
-        size_t arrayLength;
-        int16_t* array;
-        ASSERT(napi_get_typedarray_info(env, argv[0], nullptr, &arrayLength, (void**)(&array), nullptr, nullptr));
-        std::vector<int64_t>* phonemeIds = new std::vector<int64_t>(arrayLength);
-        for (uint32_t i = 0; i < arrayLength; ++i) {
-            (*phonemeIds)[i] = static_cast<int64_t>(array[i]);
+        if (!parseToPhonemeInput(env, argv[0], args->input))
+        {
+            throw std::runtime_error("Invalid phoneme ids or text");
+        }
+        if (!args->input.text.empty() && !promiseData->speaker->hasTextFrontend())
+        {
+            throw std::runtime_error("Text frontend dictionary not loaded");
         }
-        args->phonemeIds = phonemeIds;
         ASSERT(napi_get_value_int32(env, argv[1], &args->speakerId))
         ASSERT(napi_get_value_double(env, argv[2], &args->speechRate))
         ASSERT(napi_get_value_bool(env, argv[3], &args->block))
+        args->stream = false;
+        if (argc > 4)
+        {
+            ASSERT(napi_get_value_bool(env, argv[4], &args->stream))
+        }
 
         ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
 
@@ -395,17 +1383,20 @@ static napi_value sayWrapper(napi_env env, napi_callback_info info)
             [](napi_env env, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
                 SayArguments* args = (SayArguments*)promiseData->args;
-                speaker::say(
-                    *(args->phonemeIds),
+                resolvePhonemeInput(promiseData->speaker, args->input);
+                promiseData->speaker->say(
+                    args->input.view,
                     static_cast<int16_t>(args->speakerId),
                     static_cast<float>(args->speechRate),
                     args->block,
+                    args->stream,
                     args->result
                 );
             },
             [](napi_env env, napi_status status, void* data) {
                 PromiseData* promiseData = (PromiseData*)data;
                 SayArguments* args = (SayArguments*)promiseData->args;
+                releasePhonemeInput(env, args->input);
                 napi_value result;
                 ASSERT(napi_create_object(env, &result));
                 napi_value inferDuration, audioDuration;
@@ -413,8 +1404,12 @@ static napi_value sayWrapper(napi_env env, napi_callback_info info)
                 ASSERT(napi_create_int32(env, args->result.audioDuration, &audioDuration));
                 ASSERT(napi_set_named_property(env, result, "inferDuration", inferDuration));
                 ASSERT(napi_set_named_property(env, result, "audioDuration", audioDuration));
+                napi_value firstChunkDuration;
+                ASSERT(napi_create_int32(env, args->result.firstChunkDuration, &firstChunkDuration));
+                ASSERT(napi_set_named_property(env, result, "firstChunkDuration", firstChunkDuration));
                 ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
                 ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
                 delete args;
                 delete promiseData;
             },
@@ -422,6 +1417,7 @@ static napi_value sayWrapper(napi_env env, napi_callback_info info)
         ))
         
         ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
         return promise;
     }
     catch (const std::exception& e)
@@ -436,26 +1432,518 @@ static napi_value sayWrapper(napi_env env, napi_callback_info info)
 }
 
 /**
- * NAPI模块初始化
+ * 在JS线程中兑现speak的Promise
  */
-NAPI_MODULE_INIT(/*napi_env env, napi_value exports*/) {
-    napi_value initializeFn, setVolumeFn, synthesizeFn, sayFn;
+static void callSpeakDone(napi_env env, napi_value jsCallback, void* context, void* data)
+{
+    PromiseData* promiseData = (PromiseData*)data;
+    SpeakArguments* args = (SpeakArguments*)promiseData->args;
+    if (env != nullptr)
+    {
+        if (args->state == speaker::UtteranceState::Failed)
+        {
+            napi_value errorMsg;
+            ASSERT(napi_create_string_utf8(env, args->error.c_str(), NAPI_AUTO_LENGTH, &errorMsg));
+            ASSERT(napi_reject_deferred(env, static_cast<napi_deferred>(promiseData->deferred), errorMsg));
+        }
+        else
+        {
+            napi_value result;
+            ASSERT(napi_create_object(env, &result));
+            napi_value id, state, inferDuration, audioDuration, firstChunkDuration, gapDuration;
+            ASSERT(napi_create_double(env, static_cast<double>(args->id), &id));
+            const char* stateName = args->state == speaker::UtteranceState::Completed ? "completed" : "cancelled";
+            ASSERT(napi_create_string_utf8(env, stateName, NAPI_AUTO_LENGTH, &state));
+            ASSERT(napi_create_int32(env, args->result.inferDuration, &inferDuration));
+            ASSERT(napi_create_int32(env, args->result.audioDuration, &audioDuration));
+            ASSERT(napi_create_int32(env, args->result.firstChunkDuration, &firstChunkDuration));
+            ASSERT(napi_create_int32(env, args->gapDuration, &gapDuration));
+            ASSERT(napi_set_named_property(env, result, "id", id));
+            ASSERT(napi_set_named_property(env, result, "state", state));
+            ASSERT(napi_set_named_property(env, result, "inferDuration", inferDuration));
+            ASSERT(napi_set_named_property(env, result, "audioDuration", audioDuration));
+            ASSERT(napi_set_named_property(env, result, "firstChunkDuration", firstChunkDuration));
+            ASSERT(napi_set_named_property(env, result, "gapDuration", gapDuration));
+            ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
+        }
+        ASSERT(napi_release_threadsafe_function(args->onDone, napi_tsfn_release));
+        releasePhonemeInput(env, args->input);
+        releaseSpeaker(env, promiseData);
+    }
+    delete args;
+    delete promiseData;
+}
+
+/**
+ * speak函数包装：语句加入原生发音队列，播放完成、被取消或合成失败时兑现Promise
+ */
+static napi_value speakWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value promise;
+    try
+    {
+        size_t argc = 5;
+        napi_value argv[5];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 5)
+        {
+            throw std::runtime_error("Invalid arguments");
+        }
+
+        SpeakArguments* args = new SpeakArguments();
+        PromiseData* promiseData = new PromiseData();
+        promiseData->args = args;
+        PromiseGuard<SpeakArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
+
+        if (!parseToPhonemeInput(env, argv[0], args->input))
+        {
+            throw std::runtime_error("Invalid phoneme ids or text");
+        }
+        if (!args->input.text.empty() && !promiseData->speaker->hasTextFrontend())
+        {
+            throw std::runtime_error("Text frontend dictionary not loaded");
+        }
+        ASSERT(napi_get_value_int32(env, argv[1], &args->speakerId))
+        ASSERT(napi_get_value_double(env, argv[2], &args->speechRate))
+        ASSERT(napi_get_value_int32(env, argv[3], &args->priority))
+        ASSERT(napi_get_value_bool(env, argv[4], &args->interrupt))
+        // 入队时音素被复制，文本在JS线程直接转换
+        resolvePhonemeInput(promiseData->speaker, args->input);
+
+        ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
+
+        napi_value workName;
+        ASSERT(napi_create_string_utf8(env, "speak", NAPI_AUTO_LENGTH, &workName))
+        ASSERT(napi_create_threadsafe_function(env, nullptr, nullptr, workName, 0, 1,
+            nullptr, nullptr, nullptr, callSpeakDone, &args->onDone))
+        try
+        {
+            args->id = promiseData->speaker->enqueueUtterance(
+                args->input.view,
+                static_cast<uint16_t>(args->speakerId),
+                static_cast<float>(args->speechRate),
+                args->priority,
+                args->interrupt,
+                [promiseData, args](speaker::UtteranceState state, const speaker::SynthesisResult &result, int gapDuration, const std::string &error) {
+                    args->state = state;
+                    args->result = result;
+                    args->gapDuration = gapDuration;
+                    args->error = error;
+                    napi_call_threadsafe_function(args->onDone, promiseData, napi_tsfn_blocking);
+                }
+            );
+            // 已入队：由结束回调释放
+            guard.release();
+        }
+        catch (const std::exception& e)
+        {
+            // 队列已满：未入队的语句直接拒绝
+            napi_value errorMsg;
+            ASSERT(napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &errorMsg))
+            ASSERT(napi_reject_deferred(env, promiseData->deferred, errorMsg))
+        }
+        return promise;
+    }
+    catch (const std::exception& e)
+    {
+        napi_value errorMsg;
+        ASSERT(napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &errorMsg))
+        napi_deferred deferred;
+        ASSERT(napi_create_promise(env, &deferred, &promise))
+        ASSERT(napi_reject_deferred(env, deferred, errorMsg))
+        return promise;
+    }
+}
+
+/**
+ * cancel函数包装
+ */
+static napi_value cancelWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value promise;
+    try
+    {
+        size_t argc = 1;
+        napi_value argv[1];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+
+        CancelArguments* args = new CancelArguments();
+        PromiseData* promiseData = new PromiseData();
+        promiseData->args = args;
+        PromiseGuard<CancelArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
+
+        args->maxPriority = std::numeric_limits<int32_t>::max();
+        napi_valuetype valueType = napi_undefined;
+        if (argc > 0)
+        {
+            ASSERT(napi_typeof(env, argv[0], &valueType))
+        }
+        if (valueType == napi_number)
+        {
+            ASSERT(napi_get_value_int32(env, argv[0], &args->maxPriority))
+        }
+
+        ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
+
+        napi_value workName;
+        ASSERT(napi_create_string_utf8(env, "cancel", NAPI_AUTO_LENGTH, &workName))
+        ASSERT(napi_create_async_work(env, nullptr, workName, 
+            [](napi_env env, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                CancelArguments* args = (CancelArguments*)promiseData->args;
+                args->count = promiseData->speaker->cancelUtterances(args->maxPriority);
+            },
+            [](napi_env env, napi_status status, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                CancelArguments* args = (CancelArguments*)promiseData->args;
+                napi_value count;
+                ASSERT(napi_create_uint32(env, static_cast<uint32_t>(args->count), &count));
+                ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), count));
+                ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
+                delete args;
+                delete promiseData;
+            },
+            promiseData, &(promiseData->work)
+        ))
+        
+        ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
+        return promise;
+    }
+    catch (const std::exception& e)
+    {
+        napi_value errorMsg;
+        ASSERT(napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &errorMsg))
+        napi_deferred deferred;
+        ASSERT(napi_create_promise(env, &deferred, &promise))
+        ASSERT(napi_reject_deferred(env, deferred, errorMsg))
+        return promise;
+    }
+}
+
+/**
+ * 在JS线程中兑现增量文本会话的Promise
+ */
+static void callTextDone(napi_env env, napi_value jsCallback, void* context, void* data)
+{
+    PromiseData* promiseData = (PromiseData*)data;
+    TextArguments* args = (TextArguments*)promiseData->args;
+    if (env != nullptr)
+    {
+        if (args->state == speaker::UtteranceState::Failed)
+        {
+            napi_value errorMsg;
+            ASSERT(napi_create_string_utf8(env, args->error.c_str(), NAPI_AUTO_LENGTH, &errorMsg));
+            ASSERT(napi_reject_deferred(env, static_cast<napi_deferred>(promiseData->deferred), errorMsg));
+        }
+        else
+        {
+            napi_value result;
+            ASSERT(napi_create_object(env, &result));
+            napi_value id, state, sentences, inferDuration, audioDuration, firstChunkDuration;
+            ASSERT(napi_create_double(env, static_cast<double>(args->id), &id));
+            const char* stateName = args->state == speaker::UtteranceState::Completed ? "completed" : "cancelled";
+            ASSERT(napi_create_string_utf8(env, stateName, NAPI_AUTO_LENGTH, &state));
+            ASSERT(napi_create_uint32(env, static_cast<uint32_t>(args->sentences), &sentences));
+            ASSERT(napi_create_int32(env, args->result.inferDuration, &inferDuration));
+            ASSERT(napi_create_int32(env, args->result.audioDuration, &audioDuration));
+            ASSERT(napi_create_int32(env, args->result.firstChunkDuration, &firstChunkDuration));
+            ASSERT(napi_set_named_property(env, result, "id", id));
+            ASSERT(napi_set_named_property(env, result, "state", state));
+            ASSERT(napi_set_named_property(env, result, "sentences", sentences));
+            ASSERT(napi_set_named_property(env, result, "inferDuration", inferDuration));
+            ASSERT(napi_set_named_property(env, result, "audioDuration", audioDuration));
+            ASSERT(napi_set_named_property(env, result, "firstChunkDuration", firstChunkDuration));
+            ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), result));
+        }
+        ASSERT(napi_release_threadsafe_function(args->onDone, napi_tsfn_release));
+        releaseSpeaker(env, promiseData);
+    }
+    delete args;
+    delete promiseData;
+}
+
+/**
+ * beginText函数包装：开始增量文本会话，返回{ id, done }，done在会话结束且各句播放完成、被取消或合成失败时兑现
+ */
+static napi_value beginTextWrapper(napi_env env, napi_callback_info info)
+{
+    try
+    {
+        size_t argc = 4;
+        napi_value argv[4];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 4)
+        {
+            throw std::runtime_error("Invalid arguments");
+        }
+
+        speaker::Speaker* instance = nullptr;
+        ASSERT(napi_unwrap(env, thisArg, (void**)(&instance)))
+        if (!instance->hasTextFrontend())
+        {
+            throw std::runtime_error("Text frontend dictionary not loaded");
+        }
+
+        TextArguments* args = new TextArguments();
+        PromiseData* promiseData = new PromiseData();
+        promiseData->args = args;
+        PromiseGuard<TextArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
+
+        ASSERT(napi_get_value_int32(env, argv[0], &args->speakerId))
+        ASSERT(napi_get_value_double(env, argv[1], &args->speechRate))
+        ASSERT(napi_get_value_int32(env, argv[2], &args->priority))
+        ASSERT(napi_get_value_bool(env, argv[3], &args->interrupt))
+
+        napi_value promise;
+        ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
+
+        napi_value workName;
+        ASSERT(napi_create_string_utf8(env, "beginText", NAPI_AUTO_LENGTH, &workName))
+        ASSERT(napi_create_threadsafe_function(env, nullptr, nullptr, workName, 0, 1,
+            nullptr, nullptr, nullptr, callTextDone, &args->onDone))
+        args->id = promiseData->speaker->beginText(
+            static_cast<uint16_t>(args->speakerId),
+            static_cast<float>(args->speechRate),
+            args->priority,
+            args->interrupt,
+            [promiseData, args](speaker::UtteranceState state, const speaker::SynthesisResult &result, size_t sentences, const std::string &error) {
+                args->state = state;
+                args->result = result;
+                args->sentences = sentences;
+                args->error = error;
+                napi_call_threadsafe_function(args->onDone, promiseData, napi_tsfn_blocking);
+            }
+        );
 
-    // initialize函数包装暴露
-    ASSERT(napi_create_function(env, "initialize", NAPI_AUTO_LENGTH, initializeWrapper, nullptr, &initializeFn))
-    ASSERT(napi_set_named_property(env, exports, "initialize", initializeFn))
+        napi_value result, id;
+        ASSERT(napi_create_object(env, &result))
+        ASSERT(napi_create_double(env, static_cast<double>(args->id), &id))
+        ASSERT(napi_set_named_property(env, result, "id", id))
+        ASSERT(napi_set_named_property(env, result, "done", promise))
+        guard.release();
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        napi_throw_error(env, "100", e.what());
+        return nullptr;
+    }
+}
 
-    // setVolume函数包装暴露
-    ASSERT(napi_create_function(env, "setVolume", NAPI_AUTO_LENGTH, setVolumeWrapper, nullptr, &setVolumeFn))
-    ASSERT(napi_set_named_property(env, exports, "setVolume", setVolumeFn))
+/**
+ * appendText函数包装：追加文本片段，切出的完整句子同步加入发音队列，返回入队句数
+ */
+static napi_value appendTextWrapper(napi_env env, napi_callback_info info)
+{
+    try
+    {
+        size_t argc = 2;
+        napi_value argv[2];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 2)
+        {
+            throw std::runtime_error("Invalid arguments");
+        }
+        speaker::Speaker* instance = nullptr;
+        ASSERT(napi_unwrap(env, thisArg, (void**)(&instance)))
+        double id;
+        ASSERT(napi_get_value_double(env, argv[0], &id))
+        std::string fragment;
+        parseToString(env, argv[1], &fragment);
+        size_t count = instance->appendText(static_cast<uint64_t>(id), fragment);
+        napi_value result;
+        ASSERT(napi_create_uint32(env, static_cast<uint32_t>(count), &result))
+        return result;
+    }
+    catch (const std::exception& e)
+    {
+        napi_throw_error(env, "100", e.what());
+        return nullptr;
+    }
+}
 
-    // synthesize函数包装暴露
-    ASSERT(napi_create_function(env, "synthesize", NAPI_AUTO_LENGTH, synthesizeWrapper, nullptr, &synthesizeFn))
-    ASSERT(napi_set_named_property(env, exports, "synthesize", synthesizeFn))
+/**
+ * endText函数包装：结束追加，剩余文本作为最后一句入队
+ */
+static napi_value endTextWrapper(napi_env env, napi_callback_info info)
+{
+    try
+    {
+        size_t argc = 1;
+        napi_value argv[1];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 1)
+        {
+            throw std::runtime_error("Invalid arguments");
+        }
+        speaker::Speaker* instance = nullptr;
+        ASSERT(napi_unwrap(env, thisArg, (void**)(&instance)))
+        double id;
+        ASSERT(napi_get_value_double(env, argv[0], &id))
+        instance->endText(static_cast<uint64_t>(id));
+        return nullptr;
+    }
+    catch (const std::exception& e)
+    {
+        napi_throw_error(env, "100", e.what());
+        return nullptr;
+    }
+}
+
+/**
+ * cancelText函数包装
+ */
+static napi_value cancelTextWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value promise;
+    try
+    {
+        size_t argc = 1;
+        napi_value argv[1];
+        napi_value thisArg;
+        ASSERT(napi_get_cb_info(env, info, &argc, argv, &thisArg, nullptr))
+        if (argc < 1)
+        {
+            throw std::runtime_error("Invalid arguments");
+        }
+
+        CancelTextArguments* args = new CancelTextArguments();
+        PromiseData* promiseData = new PromiseData();
+        promiseData->args = args;
+        PromiseGuard<CancelTextArguments> guard(env, promiseData);
+        unwrapSpeaker(env, thisArg, promiseData);
 
-    // say函数包装暴露
-    ASSERT(napi_create_function(env, "say", NAPI_AUTO_LENGTH, sayWrapper, nullptr, &sayFn))
-    ASSERT(napi_set_named_property(env, exports, "say", sayFn))
+        double id;
+        ASSERT(napi_get_value_double(env, argv[0], &id))
+        args->id = static_cast<uint64_t>(id);
+
+        ASSERT(napi_create_promise(env, &(promiseData->deferred), &promise))
+
+        napi_value workName;
+        ASSERT(napi_create_string_utf8(env, "cancelText", NAPI_AUTO_LENGTH, &workName))
+        ASSERT(napi_create_async_work(env, nullptr, workName, 
+            [](napi_env env, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                CancelTextArguments* args = (CancelTextArguments*)promiseData->args;
+                try
+                {
+                    args->count = promiseData->speaker->cancelText(args->id);
+                }
+                catch (const std::exception& e)
+                {
+                    // 会话已结束：无可取消的语句
+                    args->count = 0;
+                }
+            },
+            [](napi_env env, napi_status status, void* data) {
+                PromiseData* promiseData = (PromiseData*)data;
+                CancelTextArguments* args = (CancelTextArguments*)promiseData->args;
+                napi_value count;
+                ASSERT(napi_create_uint32(env, static_cast<uint32_t>(args->count), &count));
+                ASSERT(napi_resolve_deferred(env, static_cast<napi_deferred>(promiseData->deferred), count));
+                ASSERT(napi_delete_async_work(env, static_cast<napi_async_work>(promiseData->work)));
+                releaseSpeaker(env, promiseData);
+                delete args;
+                delete promiseData;
+            },
+            promiseData, &(promiseData->work)
+        ))
+        
+        ASSERT(napi_queue_async_work(env, promiseData->work))
+        guard.release();
+        return promise;
+    }
+    catch (const std::exception& e)
+    {
+        napi_value errorMsg;
+        ASSERT(napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &errorMsg))
+        napi_deferred deferred;
+        ASSERT(napi_create_promise(env, &deferred, &promise))
+        ASSERT(napi_reject_deferred(env, deferred, errorMsg))
+        return promise;
+    }
+}
+
+/**
+ * getCacheStats函数包装
+ */
+static napi_value getCacheStatsWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value thisArg;
+    ASSERT(napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr))
+    speaker::Speaker* instance = nullptr;
+    ASSERT(napi_unwrap(env, thisArg, (void**)(&instance)))
+    speaker::CacheStats stats = instance->getCacheStats();
+    napi_value result;
+    ASSERT(napi_create_object(env, &result));
+    const std::pair<const char*, uint64_t> fields[] = {
+        {"hits", stats.hits},
+        {"misses", stats.misses},
+        {"memoryHits", stats.memoryHits},
+        {"fileHits", stats.fileHits},
+        {"memoryEntries", stats.memoryEntries},
+        {"memorySize", stats.memorySize},
+        {"fileEntries", stats.fileEntries},
+        {"fileSize", stats.fileSize}
+    };
+    for (const auto& field : fields) {
+        napi_value value;
+        ASSERT(napi_create_double(env, static_cast<double>(field.second), &value));
+        ASSERT(napi_set_named_property(env, result, field.first, value));
+    }
+    return result;
+}
+
+/**
+ * Speaker构造函数包装
+ */
+static napi_value constructorWrapper(napi_env env, napi_callback_info info)
+{
+    napi_value thisArg;
+    ASSERT(napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr))
+    speaker::Speaker* instance = new speaker::Speaker();
+    ASSERT(napi_wrap(env, thisArg, instance,
+        [](napi_env env, void* data, void* hint) {
+            delete (speaker::Speaker*)data;
+        },
+        nullptr, nullptr))
+    return thisArg;
+}
+
+/**
+ * NAPI模块初始化
+ */
+NAPI_MODULE_INIT(/*napi_env env, napi_value exports*/) {
+    // Speaker类暴露，每个实例独立加载模型与音频设备，共享推理运行时
+    napi_property_descriptor properties[] = {
+        {"initialize", nullptr, initializeWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"setVolume", nullptr, setVolumeWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"synthesize", nullptr, synthesizeWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"synthesizeBatch", nullptr, synthesizeBatchWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"synthesizeStream", nullptr, synthesizeStreamWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"say", nullptr, sayWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"speak", nullptr, speakWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"cancel", nullptr, cancelWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"beginText", nullptr, beginTextWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"appendText", nullptr, appendTextWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"endText", nullptr, endTextWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"cancelText", nullptr, cancelTextWrapper, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"getCacheStats", nullptr, getCacheStatsWrapper, nullptr, nullptr, nullptr, napi_default, nullptr}
+    };
+    napi_value speakerClass;
+    ASSERT(napi_define_class(env, "Speaker", NAPI_AUTO_LENGTH, constructorWrapper, nullptr,
+        sizeof(properties) / sizeof(properties[0]), properties, &speakerClass))
+    ASSERT(napi_set_named_property(env, exports, "Speaker", speakerClass))
 
     return exports;
 }
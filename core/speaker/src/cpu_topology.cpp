@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "cpu_topology.hpp"
+
+namespace speaker
+{
+
+    static bool readNumber(const std::string &path, uint32_t &value)
+    {
+        std::ifstream file(path);
+        return static_cast<bool>(file >> value);
+    }
+
+    // 解析"0-3,5,7-8"形式的核心列表
+    static std::vector<int> parseCpuList(const std::string &text)
+    {
+        std::vector<int> cpus;
+        std::stringstream stream(text);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            size_t dash = range.find('-');
+            try
+            {
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; cpu++)
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+            catch (const std::exception &)
+            {
+                continue;
+            }
+        }
+        return cpus;
+    }
+
+    static std::string formatCpuList(const std::vector<int> &cpus)
+    {
+        std::string text;
+        for (size_t i = 0; i < cpus.size(); i++)
+        {
+            // 连续核心合并为区间
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            {
+                j++;
+            }
+            if (!text.empty())
+            {
+                text += ",";
+            }
+            text += std::to_string(cpus[i]);
+            if (j > i)
+            {
+                text += "-" + std::to_string(cpus[j]);
+            }
+            i = j;
+        }
+        return text;
+    }
+
+    std::vector<CpuCluster> readCpuClusters(const std::string &sysfsRoot)
+    {
+        std::ifstream onlineFile(sysfsRoot + "/online");
+        std::string online;
+        if (!std::getline(onlineFile, online))
+        {
+            return {};
+        }
+        std::map<uint32_t, std::vector<int>, std::greater<uint32_t>> groups;
+        for (int cpu : parseCpuList(online))
+        {
+            std::string cpuRoot = sysfsRoot + "/cpu" + std::to_string(cpu);
+            uint32_t capacity = 0;
+            // 大小核架构内核导出cpu_capacity，否则以最高频率近似算力
+            if (!readNumber(cpuRoot + "/cpu_capacity", capacity))
+            {
+                readNumber(cpuRoot + "/cpufreq/cpuinfo_max_freq", capacity);
+            }
+            groups[capacity].push_back(cpu);
+        }
+        std::vector<CpuCluster> clusters;
+        for (auto &group : groups)
+        {
+            CpuCluster cluster;
+            cluster.capacity = group.first;
+            cluster.cpus = std::move(group.second);
+            clusters.push_back(std::move(cluster));
+        }
+        return clusters;
+    }
+
+    ThreadPlacement planThreadPlacement(const std::vector<CpuCluster> &clusters, uint16_t numThreads, const PlacementConfig &config)
+    {
+        ThreadPlacement placement;
+        placement.clusters = clusters;
+        const std::string &policy = config.inferenceCluster;
+        // 同构CPU由系统调度即可，auto时不绑定
+        if (policy == "none" || clusters.empty() || (policy == "auto" && clusters.size() < 2))
+        {
+            return placement;
+        }
+        std::vector<CpuCluster> ordered = clusters;
+        if (policy == "little")
+        {
+            std::reverse(ordered.begin(), ordered.end());
+        }
+        std::vector<int> candidates;
+        for (const CpuCluster &cluster : ordered)
+        {
+            candidates.insert(candidates.end(), cluster.cpus.begin(), cluster.cpus.end());
+        }
+        // 音频线程取最后一个簇的最后一个核心，与推理线程隔离
+        if (config.pinAudio && candidates.size() > 1)
+        {
+            placement.audioCpus.push_back(candidates.back());
+            candidates.pop_back();
+        }
+        // 未指定线程数时占满首选簇，超出首选簇的线程依次溢出到下一簇
+        size_t sessions = std::max<size_t>(1, config.sessions);
+        size_t count = numThreads > 0 ? numThreads * sessions : ordered.front().cpus.size();
+        count = std::min(count, candidates.size());
+        placement.inferenceCpus.assign(candidates.begin(), candidates.begin() + count);
+        // 各会话依次分得连续的核心，核心不足时减少会话数
+        sessions = std::min(sessions, count);
+        for (size_t i = 0; i < sessions; i++)
+        {
+            placement.sessionCpus.emplace_back(placement.inferenceCpus.begin() + i * count / sessions, placement.inferenceCpus.begin() + (i + 1) * count / sessions);
+        }
+        return placement;
+    }
+
+    std::string ThreadPlacement::describe() const
+    {
+        std::string text = "clusters=";
+        for (size_t i = 0; i < clusters.size(); i++)
+        {
+            text += (i > 0 ? "," : "") + std::string("[") + formatCpuList(clusters[i].cpus) + "]@" + std::to_string(clusters[i].capacity);
+        }
+        text += " inference=" + (inferenceCpus.empty() ? std::string("unpinned") : formatCpuList(inferenceCpus));
+        if (sessionCpus.size() > 1)
+        {
+            text += " sessions=";
+            for (size_t i = 0; i < sessionCpus.size(); i++)
+            {
+                text += (i > 0 ? "|" : "") + formatCpuList(sessionCpus[i]);
+            }
+        }
+        text += " audio=" + (audioCpus.empty() ? std::string("unpinned") : formatCpuList(audioCpus));
+        return text;
+    }
+
+    std::string formatIntraOpAffinities(const std::vector<int> &cpus)
+    {
+        std::string text;
+        for (size_t i = 1; i < cpus.size(); i++)
+        {
+            if (i > 1)
+            {
+                text += ";";
+            }
+            text += std::to_string(cpus[i] + 1);
+        }
+        return text;
+    }
+
+#ifdef __linux__
+    bool setCurrentThreadAffinity(const std::vector<int> &cpus)
+    {
+        if (cpus.empty())
+        {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus)
+        {
+            CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int> &cpus)
+    {
+        if (cpus.empty())
+        {
+            return;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        {
+            return;
+        }
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                previousCpus.push_back(cpu);
+            }
+        }
+        applied = setCurrentThreadAffinity(cpus);
+    }
+
+    ScopedThreadAffinity::~ScopedThreadAffinity()
+    {
+        if (applied)
+        {
+            setCurrentThreadAffinity(previousCpus);
+        }
+    }
+#else
+    bool setCurrentThreadAffinity(const std::vector<int> &cpus)
+    {
+        return false;
+    }
+
+    ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int> &cpus) {}
+
+    ScopedThreadAffinity::~ScopedThreadAffinity() {}
+#endif
+
+}
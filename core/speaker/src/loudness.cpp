@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cmath>
+
+#include "audio_kernel.hpp"
+#include "loudness.hpp"
+
+namespace speaker
+{
+
+    StreamingLimiter::StreamingLimiter(const LimiterConfig &_config)
+    {
+        configure(_config);
+    }
+
+    void StreamingLimiter::configure(const LimiterConfig &_config)
+    {
+        config = _config;
+        config.lookahead = std::max<uint32_t>(1, config.lookahead);
+        releaseCoefficient = 1.0f - std::exp(-1.0f / std::max<uint32_t>(1, config.release));
+        delayLine.assign(config.lookahead, 0.0f);
+        holdValues.assign(config.lookahead, 1.0f);
+        minIndex.assign(config.lookahead, 0);
+        minValue.assign(config.lookahead, 1.0f);
+        reset();
+    }
+
+    void StreamingLimiter::reset()
+    {
+        std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+        std::fill(holdValues.begin(), holdValues.end(), 1.0f);
+        minHead = 0;
+        minTail = 0;
+        holdSum = config.lookahead;
+        envelope = 1.0f;
+        position = 0;
+        relaxedFrom = 0;
+    }
+
+    // 输入一个采样，延迟线填满后输出lookahead - 1个样本之前的采样
+    bool StreamingLimiter::push(float sample, int16_t &out)
+    {
+        const size_t window = config.lookahead;
+        float magnitude = std::fabs(sample);
+        float required = 1.0f;
+        if (magnitude > config.threshold)
+        {
+            required = config.threshold / magnitude;
+            limited++;
+            // 该样本离开滑动最小值窗口后还需一个窗口才离开滑动平均
+            relaxedFrom = position + 2 * window;
+        }
+
+        // 单调队列求窗口内所需增益的最小值：先移出窗口外的元素，保证队列长度不超过窗口
+        while (minTail > minHead && minIndex[minHead % window] + window <= position)
+        {
+            minHead++;
+        }
+        while (minTail > minHead && minValue[(minTail - 1) % window] >= required)
+        {
+            minTail--;
+        }
+        minIndex[minTail % window] = position;
+        minValue[minTail % window] = required;
+        minTail++;
+        float hold = minValue[minHead % window];
+
+        // 窗口最小值的滑动平均：输出样本所在的每个窗口都覆盖它，平均值不超过其所需增益
+        size_t slot = position % window;
+        holdSum += hold - holdValues[slot];
+        holdValues[slot] = hold;
+        if (position >= relaxedFrom)
+        {
+            holdSum = static_cast<double>(window); // 消除累加误差
+        }
+        float smoothed = static_cast<float>(holdSum / window);
+        envelope = smoothed < envelope ? smoothed : envelope + (smoothed - envelope) * releaseCoefficient;
+        // 指数恢复在浮点下无法精确回到1，差值低于1e-4（约3个int16刻度）时直接恢复
+        if (smoothed == 1.0f && envelope > 0.9999f)
+        {
+            envelope = 1.0f;
+        }
+
+        delayLine[slot] = sample;
+        position++;
+        if (position < window)
+        {
+            return false;
+        }
+        float value = delayLine[position % window] * envelope;
+        value = std::min(32767.0f, std::max(-32768.0f, value));
+        out = static_cast<int16_t>(value);
+        return true;
+    }
+
+    // 限幅未生效且本块无需限幅：输出延迟线中的样本与本块乘以固定增益后的样本，末尾留在延迟线中，
+    // 状态与逐样本处理一致（所需增益均为1，单调队列只剩最后一个样本）
+    size_t StreamingLimiter::passThrough(const float *data, size_t count, int16_t *out)
+    {
+        const size_t window = config.lookahead;
+        const size_t latency = window - 1;
+        size_t delayed = std::min<uint64_t>(position, latency); // 延迟线中待输出的样本数
+        size_t total = delayed + count;
+        size_t written = total > latency ? total - latency : 0;
+        size_t fromDelay = std::min(written, delayed);
+        size_t slot = (position - delayed) % window;
+        for (size_t i = 0; i < fromDelay; i++)
+        {
+            float value = delayLine[slot];
+            out[i] = static_cast<int16_t>(std::min(32767.0f, std::max(-32768.0f, value)));
+            slot = slot + 1 == window ? 0 : slot + 1;
+        }
+        scaleToInt16(data, out + fromDelay, written - fromDelay, config.gain);
+        size_t tail = count > latency ? count - latency : 0;
+        slot = (position + tail) % window;
+        for (size_t i = tail; i < count; i++)
+        {
+            delayLine[slot] = data[i] * config.gain;
+            slot = slot + 1 == window ? 0 : slot + 1;
+        }
+        position += count;
+        minHead = 0;
+        minTail = 1;
+        minIndex[0] = position - 1;
+        minValue[0] = 1.0f;
+        return written;
+    }
+
+    size_t StreamingLimiter::process(const float *data, size_t count, int16_t *out)
+    {
+        // 分块判断：限幅已完全退出时，连续的块内峰值乘以增益不超过阈值的块合并为一次向量化处理
+        static constexpr size_t BLOCK_SIZE = 256;
+        size_t written = 0;
+        size_t begin = 0;
+        while (begin < count)
+        {
+            if (position >= relaxedFrom && envelope == 1.0f)
+            {
+                size_t end = begin;
+                while (end < count)
+                {
+                    size_t size = std::min(BLOCK_SIZE, count - end);
+                    if (peakAbs(data + end, size) * config.gain > config.threshold)
+                    {
+                        break;
+                    }
+                    end += size;
+                }
+                if (end > begin)
+                {
+                    written += passThrough(data + begin, end - begin, out + written);
+                    begin = end;
+                    continue;
+                }
+            }
+            size_t end = std::min(begin + BLOCK_SIZE, count);
+            for (; begin < end; begin++)
+            {
+                if (push(data[begin] * config.gain, out[written]))
+                {
+                    written++;
+                }
+            }
+        }
+        return written;
+    }
+
+    size_t StreamingLimiter::flush(int16_t *out)
+    {
+        // 以静音推出延迟线中的样本
+        size_t written = 0;
+        for (size_t i = 0; i < latency(); i++)
+        {
+            if (push(0.0f, out[written]))
+            {
+                written++;
+            }
+        }
+        reset();
+        return written;
+    }
+
+}
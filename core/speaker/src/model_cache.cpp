@@ -0,0 +1,108 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "model_cache.hpp"
+
+namespace speaker
+{
+
+#if defined(__aarch64__)
+    static const char *CPU_ARCH = "aarch64";
+#elif defined(__arm__)
+    static const char *CPU_ARCH = "arm";
+#elif defined(__x86_64__) || defined(_M_X64)
+    static const char *CPU_ARCH = "x86_64";
+#else
+    static const char *CPU_ARCH = "unknown";
+#endif
+
+    // 按8字节分组的FNV-1a哈希，百MB级模型也只需很短时间
+    uint64_t hashFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("model file open failed: " + path);
+        }
+        uint64_t hash = 14695981039346656037ULL;
+        std::vector<char> buffer(1 << 20);
+        while (file)
+        {
+            file.read(buffer.data(), buffer.size());
+            size_t size = static_cast<size_t>(file.gcount());
+            size_t offset = 0;
+            for (; offset + 8 <= size; offset += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, buffer.data() + offset, 8);
+                hash = (hash ^ word) * 1099511628211ULL;
+            }
+            for (; offset < size; offset++)
+            {
+                hash = (hash ^ static_cast<uint8_t>(buffer[offset])) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+    std::string optimizedModelCacheKey(const std::string &modelPath)
+    {
+        std::ostringstream key;
+        key << std::hex << std::setw(16) << std::setfill('0') << hashFile(modelPath)
+            << "-ort" << OrtGetApiBase()->GetVersionString() << "-" << CPU_ARCH;
+        return key.str();
+    }
+
+    Ort::Session createCachedSession(Ort::Env &env, const std::string &modelPath, const Ort::SessionOptions &options, Ort::PrepackedWeightsContainer &prepackedWeights, const std::string &cacheDir)
+    {
+        if (cacheDir.empty())
+        {
+            return Ort::Session(env, modelPath.c_str(), options, prepackedWeights);
+        }
+        std::filesystem::path cachePath = std::filesystem::path(cacheDir) /
+            (std::filesystem::path(modelPath).stem().string() + "-" + optimizedModelCacheKey(modelPath) + ".onnx");
+        if (std::filesystem::exists(cachePath))
+        {
+            // 缓存模型已完成全部图优化，加载时不再重复优化
+            Ort::SessionOptions cachedOptions = options.Clone();
+            cachedOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            try
+            {
+                Ort::Session session(env, cachePath.c_str(), cachedOptions, prepackedWeights);
+                std::cerr << "speaker optimized model cache hit: " << cachePath.string() << std::endl;
+                return session;
+            }
+            catch (const Ort::Exception &e)
+            {
+                std::cerr << "speaker optimized model cache invalid, rebuilding: " << e.what() << std::endl;
+                std::error_code error;
+                std::filesystem::remove(cachePath, error);
+            }
+        }
+        std::error_code error;
+        std::filesystem::create_directories(cacheDir, error);
+        // 先写入临时文件再重命名，避免多进程同时启动时读到不完整的缓存
+        std::filesystem::path tempPath = cachePath;
+        tempPath += ".tmp" + std::to_string(std::random_device()());
+        Ort::SessionOptions optimizeOptions = options.Clone();
+        optimizeOptions.SetOptimizedModelFilePath(tempPath.c_str());
+        Ort::Session session(env, modelPath.c_str(), optimizeOptions, prepackedWeights);
+        std::filesystem::rename(tempPath, cachePath, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+        }
+        else
+        {
+            std::cerr << "speaker optimized model cached: " << cachePath.string() << std::endl;
+        }
+        return session;
+    }
+
+}
@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cerrno>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sched.h>
+
+#ifdef USE_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+#include "cpu_topology.hpp"
+#include "playback.hpp"
+
+namespace speaker
+{
+
+#ifdef USE_ALSA
+    AlsaSink::AlsaSink(const std::string &_deviceName) : deviceName(_deviceName) {}
+
+    AlsaSink::~AlsaSink()
+    {
+        if (pcmHandle != nullptr)
+        {
+            snd_pcm_close(pcmHandle);
+        }
+    }
+
+    void AlsaSink::open(PlaybackConfig &config)
+    {
+        int error = snd_pcm_open(&pcmHandle, deviceName.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+        if (error < 0)
+        {
+            throw std::runtime_error("audio device open failed: " + deviceName + " " + snd_strerror(error));
+        }
+        snd_pcm_hw_params_t *params;
+        snd_pcm_hw_params_malloc(&params);
+        snd_pcm_hw_params_any(pcmHandle, params);
+        // 优先mmap访问，减少一次内核拷贝；部分插件设备不支持时回退到读写方式
+        mmapAccess = snd_pcm_hw_params_set_access(pcmHandle, params, SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0;
+        if (!mmapAccess)
+        {
+            snd_pcm_hw_params_set_access(pcmHandle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+        }
+        snd_pcm_hw_params_set_format(pcmHandle, params, SND_PCM_FORMAT_S16_LE);
+        snd_pcm_hw_params_set_channels(pcmHandle, params, 1);
+        snd_pcm_hw_params_set_rate_near(pcmHandle, params, &config.sampleRate, NULL);
+        snd_pcm_uframes_t periodSize = config.periodSize;
+        snd_pcm_uframes_t bufferSize = config.bufferSize;
+        snd_pcm_hw_params_set_period_size_near(pcmHandle, params, &periodSize, NULL);
+        snd_pcm_hw_params_set_buffer_size_near(pcmHandle, params, &bufferSize);
+        error = snd_pcm_hw_params(pcmHandle, params);
+        snd_pcm_hw_params_free(params);
+        if (error < 0)
+        {
+            throw std::runtime_error(std::string("audio device setup failed: ") + snd_strerror(error));
+        }
+        config.periodSize = static_cast<uint32_t>(periodSize);
+        config.bufferSize = static_cast<uint32_t>(bufferSize);
+
+        // 写满一个周期即开始播放
+        snd_pcm_sw_params_t *swParams;
+        snd_pcm_sw_params_malloc(&swParams);
+        snd_pcm_sw_params_current(pcmHandle, swParams);
+        snd_pcm_sw_params_set_start_threshold(pcmHandle, swParams, periodSize);
+        snd_pcm_sw_params_set_avail_min(pcmHandle, swParams, periodSize);
+        snd_pcm_sw_params(pcmHandle, swParams);
+        snd_pcm_sw_params_free(swParams);
+        snd_pcm_prepare(pcmHandle);
+    }
+
+    void AlsaSink::write(const int16_t *data, size_t frames)
+    {
+        while (frames > 0)
+        {
+            snd_pcm_sframes_t written = mmapAccess
+                                            ? snd_pcm_mmap_writei(pcmHandle, data, frames)
+                                            : snd_pcm_writei(pcmHandle, data, frames);
+            if (written == -EAGAIN)
+            {
+                snd_pcm_wait(pcmHandle, 100);
+                continue;
+            }
+            if (written < 0)
+            {
+                recover(static_cast<int>(written));
+                continue;
+            }
+            data += written;
+            frames -= written;
+        }
+    }
+
+    void AlsaSink::drain()
+    {
+        snd_pcm_drain(pcmHandle);
+        snd_pcm_prepare(pcmHandle);
+    }
+
+    void AlsaSink::drop()
+    {
+        snd_pcm_drop(pcmHandle);
+        snd_pcm_prepare(pcmHandle);
+    }
+
+    void AlsaSink::recover(int error)
+    {
+        xruns++;
+        error = snd_pcm_recover(pcmHandle, error, 1);
+        if (error < 0)
+        {
+            throw std::runtime_error(std::string("audio device recover failed: ") + snd_strerror(error));
+        }
+    }
+#endif
+
+    void NullSink::open(PlaybackConfig &config)
+    {
+        sampleRate = config.sampleRate;
+    }
+
+    void NullSink::write(const int16_t *, size_t frames)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(frames * 1000000 / sampleRate));
+    }
+
+    WavSink::WavSink(const std::string &_filePath) : filePath(_filePath) {}
+
+    WavSink::~WavSink()
+    {
+        if (file != nullptr)
+        {
+            writeHeader();
+            std::fclose(file);
+        }
+    }
+
+    void WavSink::open(PlaybackConfig &config)
+    {
+        sampleRate = config.sampleRate;
+        file = std::fopen(filePath.c_str(), "wb");
+        if (file == nullptr)
+        {
+            throw std::runtime_error("wav file open failed: " + filePath);
+        }
+        writeHeader();
+    }
+
+    void WavSink::write(const int16_t *data, size_t frames)
+    {
+        dataSize += static_cast<uint32_t>(std::fwrite(data, sizeof(int16_t), frames, file) * sizeof(int16_t));
+    }
+
+    void WavSink::drain()
+    {
+        writeHeader();
+    }
+
+    void WavSink::writeHeader()
+    {
+        // 单声道16位PCM
+        uint32_t riffSize = 36 + dataSize;
+        uint32_t fmtSize = 16;
+        uint16_t audioFormat = 1;
+        uint16_t numChannels = 1;
+        uint32_t byteRate = sampleRate * sizeof(int16_t);
+        uint16_t blockAlign = sizeof(int16_t);
+        uint16_t bitsPerSample = 16;
+        std::fseek(file, 0, SEEK_SET);
+        std::fwrite("RIFF", 1, 4, file);
+        std::fwrite(&riffSize, 4, 1, file);
+        std::fwrite("WAVEfmt ", 1, 8, file);
+        std::fwrite(&fmtSize, 4, 1, file);
+        std::fwrite(&audioFormat, 2, 1, file);
+        std::fwrite(&numChannels, 2, 1, file);
+        std::fwrite(&sampleRate, 4, 1, file);
+        std::fwrite(&byteRate, 4, 1, file);
+        std::fwrite(&blockAlign, 2, 1, file);
+        std::fwrite(&bitsPerSample, 2, 1, file);
+        std::fwrite("data", 1, 4, file);
+        std::fwrite(&dataSize, 4, 1, file);
+        std::fseek(file, 0, SEEK_END);
+        std::fflush(file);
+    }
+
+    std::unique_ptr<AudioSink> createAudioSink(const std::string &deviceName)
+    {
+        if (deviceName == "null")
+        {
+            return std::make_unique<NullSink>();
+        }
+        if (deviceName.rfind("wav:", 0) == 0)
+        {
+            return std::make_unique<WavSink>(deviceName.substr(4));
+        }
+#ifdef USE_ALSA
+        return std::make_unique<AlsaSink>(deviceName);
+#else
+        throw std::runtime_error("please USE_ALSA or use null / wav:<path> audio device!");
+#endif
+    }
+
+    PlaybackEngine::~PlaybackEngine()
+    {
+        stop();
+    }
+
+    void PlaybackEngine::start(std::unique_ptr<AudioSink> _sink, const PlaybackConfig &_config)
+    {
+        stop();
+        config = _config;
+        sink = std::move(_sink);
+        sink->open(config);
+        ringBuffer.resize(static_cast<size_t>(config.sampleRate) * config.ringBufferDuration / 1000);
+        enqueuedSamples = 0;
+        playedSamples = 0;
+        running = true;
+        thread = std::thread(&PlaybackEngine::run, this);
+    }
+
+    void PlaybackEngine::stop()
+    {
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+        wakeUp();
+        thread.join();
+    }
+
+    void PlaybackEngine::enqueue(const int16_t *data, size_t samples)
+    {
+        uint64_t generation = flushGeneration.load();
+        std::lock_guard<std::mutex> producerLock(producerMutex);
+        while (samples > 0)
+        {
+            // 单生产者下可写空间只增不减，先发布写入计数再写入：回放线程读到的样本均已计入，playedSamples不会超过enqueuedSamples
+            size_t written = std::min(samples, ringBuffer.space());
+            if (written > 0)
+            {
+                enqueuedSamples += written;
+                ringBuffer.write(data, written);
+                data += written;
+                samples -= written;
+                wakeUp();
+                continue;
+            }
+            // 缓冲区已满，等待回放线程消费
+            std::unique_lock<std::mutex> lock(stateMutex);
+            stateCv.wait_for(lock, std::chrono::milliseconds(10), [&] { return ringBuffer.space() > 0 || !running || flushGeneration.load() != generation; });
+            if (!running || flushGeneration.load() != generation)
+            {
+                return;
+            }
+        }
+    }
+
+    void PlaybackEngine::flush()
+    {
+        // 先递增计数使阻塞中的写入尽快释放生产者锁
+        flushGeneration++;
+        std::lock_guard<std::mutex> producerLock(producerMutex);
+        if (!running)
+        {
+            return;
+        }
+        flushRequested = true;
+        wakeUp();
+        std::unique_lock<std::mutex> lock(stateMutex);
+        stateCv.wait(lock, [&] { return !flushRequested || !running; });
+    }
+
+    void PlaybackEngine::drain()
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        if (busy())
+        {
+            drainRequested = true;
+            dataCv.notify_one();
+        }
+        stateCv.wait(lock, [&] { return !busy() || !running; });
+    }
+
+    void PlaybackEngine::skip(uint64_t begin, uint64_t end)
+    {
+        {
+            std::lock_guard<std::mutex> lock(skipMutex);
+            skipRanges[begin] = end;
+            skipPending = true;
+        }
+        wakeUp();
+    }
+
+    void PlaybackEngine::waitPlayed(uint64_t position)
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        stateCv.wait(lock, [&] { return playedSamples.load() >= position || !running; });
+    }
+
+    void PlaybackEngine::waitQueuedBelow(uint64_t samples, const std::atomic<bool> &abort)
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (enqueuedSamples.load() - playedSamples.load() >= samples && !abort && running)
+        {
+            // abort由其它线程置位且不通知，定时检查
+            stateCv.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    // 处理待跳过区间（回放线程）：当前位置落在区间内时丢弃区间内已写入的数据并返回丢弃数，
+    // 否则将本次读取帧数限制在下一区间起点之前
+    size_t PlaybackEngine::applySkips(size_t &frames)
+    {
+        std::lock_guard<std::mutex> lock(skipMutex);
+        uint64_t position = playedSamples.load();
+        while (!skipRanges.empty() && skipRanges.begin()->second <= position)
+        {
+            skipRanges.erase(skipRanges.begin());
+            skipDropped = false;
+        }
+        if (skipRanges.empty())
+        {
+            skipPending = false;
+            return 0;
+        }
+        auto range = skipRanges.begin();
+        if (range->first > position)
+        {
+            frames = static_cast<size_t>(std::min<uint64_t>(frames, range->first - position));
+            return 0;
+        }
+        size_t discarded = ringBuffer.discard(static_cast<size_t>(std::min<uint64_t>(range->second - position, ringBuffer.size())));
+        if (discarded > 0 && range->first < position && !skipDropped)
+        {
+            // 设备缓冲中已有区间内的音频，一并丢弃
+            sink->drop();
+            skipDropped = true;
+        }
+        if (range->second <= position + discarded)
+        {
+            skipRanges.erase(range);
+            skipDropped = false;
+        }
+        playedSamples += discarded;
+        return discarded;
+    }
+
+    bool PlaybackEngine::busy() const
+    {
+        return playedSamples.load() != enqueuedSamples.load() || !idle.load();
+    }
+
+    uint64_t PlaybackEngine::xrunCount() const
+    {
+        return sink ? sink->xrunCount() : 0;
+    }
+
+    void PlaybackEngine::wakeUp()
+    {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+        }
+        dataCv.notify_one();
+    }
+
+    void PlaybackEngine::run()
+    {
+        if (config.realtime)
+        {
+            // 无CAP_SYS_NICE权限时保持普通调度
+            sched_param param{};
+            param.sched_priority = sched_get_priority_max(SCHED_FIFO) / 2;
+            pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        }
+        setCurrentThreadAffinity(config.cpus);
+        std::vector<int16_t> period(config.periodSize);
+        // 空闲超时不短于设备缓冲时长，超时时设备中的音频已播完，排空不再阻塞
+        auto idleTimeout = std::chrono::milliseconds(std::max<uint64_t>(config.idleTimeout, static_cast<uint64_t>(config.bufferSize) * 1000 / config.sampleRate));
+        while (running)
+        {
+            if (flushRequested)
+            {
+                playedSamples += ringBuffer.discard();
+                sink->drop();
+                idle = true;
+                {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    flushRequested = false;
+                    drainRequested = false;
+                }
+                stateCv.notify_all();
+                continue;
+            }
+            size_t frames = period.size();
+            if (skipPending && applySkips(frames) > 0)
+            {
+                stateCv.notify_all();
+                continue;
+            }
+            frames = ringBuffer.read(period.data(), frames);
+            if (frames > 0)
+            {
+                idle = false;
+                try
+                {
+                    sink->write(period.data(), frames);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "playback error: " << e.what() << std::endl;
+                }
+                playedSamples += frames;
+                stateCv.notify_all();
+                continue;
+            }
+            if (!idle)
+            {
+                // 分块之间或合成落后于播放时缓冲区短暂为空，设备保持运行（欠载由写入时恢复），
+                // 显式请求排空或持续空闲超时后才排空设备，等待期间仍响应清空请求
+                {
+                    std::unique_lock<std::mutex> lock(stateMutex);
+                    dataCv.wait_for(lock, idleTimeout, [&] { return !running || flushRequested || drainRequested || !ringBuffer.empty(); });
+                }
+                if (!running || flushRequested || !ringBuffer.empty())
+                {
+                    continue;
+                }
+                sink->drain();
+                {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    idle = true;
+                    drainRequested = false;
+                }
+                stateCv.notify_all();
+            }
+            std::unique_lock<std::mutex> lock(stateMutex);
+            dataCv.wait(lock, [&] { return !running || flushRequested || !ringBuffer.empty(); });
+        }
+        sink->drop();
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            idle = true;
+        }
+        stateCv.notify_all();
+    }
+
+}
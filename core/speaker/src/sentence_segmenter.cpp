@@ -0,0 +1,213 @@
+#include <cstdint>
+
+#include "sentence_segmenter.hpp"
+
+namespace speaker
+{
+
+    // 解码一个UTF-8字符，返回字节数，字符不完整（多字节字符被片段截断）时返回0
+    static size_t decodeUtf8(const std::string &text, size_t pos, char32_t &codepoint)
+    {
+        uint8_t lead = static_cast<uint8_t>(text[pos]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 1;
+        if (pos + length > text.size())
+        {
+            return 0;
+        }
+        codepoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+        for (size_t i = 1; i < length; i++)
+        {
+            codepoint = (codepoint << 6) | (static_cast<uint8_t>(text[pos + i]) & 0x3F);
+        }
+        return length;
+    }
+
+    // 句末标点（ASCII句点需结合下文判断，单独处理）
+    static bool isTerminator(char32_t codepoint)
+    {
+        switch (codepoint)
+        {
+        case U'。':
+        case U'！':
+        case U'？':
+        case U'；':
+        case U'…':
+        case U'!':
+        case U'?':
+        case U';':
+        case U'~':
+        case U'\n':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 句中停顿
+    static bool isClause(char32_t codepoint)
+    {
+        switch (codepoint)
+        {
+        case U'，':
+        case U'、':
+        case U'：':
+        case U',':
+        case U':':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 右引号与右括号，并入其前的句子
+    static bool isCloser(char32_t codepoint)
+    {
+        switch (codepoint)
+        {
+        case U'”':
+        case U'’':
+        case U'」':
+        case U'』':
+        case U'》':
+        case U'】':
+        case U'）':
+        case U')':
+        case U'"':
+        case U'\'':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool isSpace(char32_t codepoint)
+    {
+        return codepoint == U' ' || codepoint == U'\t' || codepoint == U'\r' || codepoint == U'\n' || codepoint == U'　';
+    }
+
+    static bool isOpener(char32_t codepoint)
+    {
+        switch (codepoint)
+        {
+        case U'“':
+        case U'‘':
+        case U'「':
+        case U'『':
+        case U'《':
+        case U'【':
+        case U'（':
+        case U'(':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void SentenceSegmenter::configure(size_t _firstClauseLength, size_t _clauseLength)
+    {
+        firstClauseLength = _firstClauseLength;
+        clauseLength = _clauseLength;
+    }
+
+    void SentenceSegmenter::append(const std::string &fragment, std::vector<std::string> &sentences)
+    {
+        buffer += fragment;
+        scan(false, sentences);
+    }
+
+    void SentenceSegmenter::finish(std::vector<std::string> &sentences)
+    {
+        scan(true, sentences);
+        if (!buffer.empty())
+        {
+            emit(buffer.size(), sentences);
+        }
+        count = 0;
+    }
+
+    void SentenceSegmenter::reset()
+    {
+        buffer.clear();
+        position = 0;
+        length = 0;
+        count = 0;
+    }
+
+    void SentenceSegmenter::scan(bool finishing, std::vector<std::string> &sentences)
+    {
+        while (position < buffer.size())
+        {
+            char32_t codepoint;
+            size_t size = decodeUtf8(buffer, position, codepoint);
+            if (size == 0)
+            {
+                if (!finishing)
+                {
+                    return;
+                }
+                // 文本结束时残缺的字节按单字节处理
+                codepoint = static_cast<uint8_t>(buffer[position]);
+                size = 1;
+            }
+            size_t end = position + size;
+            bool terminator = isTerminator(codepoint) || codepoint == U'.';
+            bool clause = isClause(codepoint) && length >= (count == 0 ? firstClauseLength : clauseLength);
+            if (terminator || clause)
+            {
+                // 吸收其后连续的句末标点与右引号括号，片段在此处截断时等待后续文本
+                size_t next = end;
+                char32_t following = 0;
+                bool complete = false;
+                while (next < buffer.size())
+                {
+                    size_t followingSize = decodeUtf8(buffer, next, following);
+                    if (followingSize == 0)
+                    {
+                        break;
+                    }
+                    if (!isCloser(following) && !(terminator && (isTerminator(following) || following == U'.')))
+                    {
+                        complete = true;
+                        break;
+                    }
+                    next += followingSize;
+                }
+                if (!complete && !finishing)
+                {
+                    return;
+                }
+                // 句点后紧跟非空白字符时为小数点、缩写或网址
+                bool boundary = codepoint != U'.' || next > end || !complete || isSpace(following);
+                if (boundary)
+                {
+                    emit(next, sentences);
+                    continue;
+                }
+            }
+            if (!isSpace(codepoint) && !isTerminator(codepoint) && !isClause(codepoint) && !isCloser(codepoint) && !isOpener(codepoint) && codepoint != U'.')
+            {
+                length++;
+            }
+            position = end;
+        }
+    }
+
+    // 切出[0, end)作为一句，仅含空白与标点时丢弃
+    void SentenceSegmenter::emit(size_t end, std::vector<std::string> &sentences)
+    {
+        std::string sentence = buffer.substr(0, end);
+        buffer.erase(0, end);
+        bool speakable = length > 0;
+        position = 0;
+        length = 0;
+        size_t begin = sentence.find_first_not_of(" \t\r\n");
+        size_t last = sentence.find_last_not_of(" \t\r\n");
+        if (!speakable || begin == std::string::npos)
+        {
+            return;
+        }
+        sentences.push_back(sentence.substr(begin, last - begin + 1));
+        count++;
+    }
+
+}
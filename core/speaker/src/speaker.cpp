@@ -1,40 +1,51 @@
 #include <iostream>
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <limits>
 #include <sstream>
 
 #include <onnxruntime_cxx_api.h>
+#ifdef USE_ALSA
 #include <alsa/asoundlib.h>
+#endif
 
+#include "audio_kernel.hpp"
+#include "model_cache.hpp"
 #include "speaker.hpp"
 
 namespace speaker
 {
 
-    speaker::Model model;
-    snd_pcm_t *pcmHandle;
-    std::string audioDeviceName;
-    std::string audioMixerName;
+    // 当前线程的推理是否属于发音队列语句（发音线程及其派发的并行合成线程），取消语句时仅终止这些推理
+    static thread_local bool utteranceInference = false;
 
-#ifdef USE_ALSA
-    void alsaOpen()
+    Runtime::Runtime() : env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "speaker")
     {
-        snd_pcm_hw_params_t *params;
-        snd_pcm_open(&pcmHandle, audioDeviceName.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
-        snd_pcm_hw_params_malloc(&params);
-        snd_pcm_hw_params_any(pcmHandle, params);
-        snd_pcm_hw_params_set_access(pcmHandle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
-        snd_pcm_hw_params_set_format(pcmHandle, params, SND_PCM_FORMAT_S16_LE);
-        snd_pcm_hw_params_set_channels(pcmHandle, params, 1);
-        snd_pcm_hw_params_set_rate_near(pcmHandle, params, &model.config.sampleRate, NULL);
-        snd_pcm_hw_params(pcmHandle, params);
-        snd_pcm_hw_params_free(params);
-        snd_pcm_prepare(pcmHandle);
+        env.DisableTelemetryEvents();
     }
 
-    void alsaSetVolume(const uint16_t &volume)
+    std::shared_ptr<Runtime> Runtime::get()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<Runtime> instance;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<Runtime> runtime = instance.lock();
+        if (!runtime)
+        {
+            runtime = std::make_shared<Runtime>();
+            instance = runtime;
+        }
+        return runtime;
+    }
+
+#ifdef USE_ALSA
+    static void alsaSetVolume(const std::string &audioDeviceName, const std::string &audioMixerName, const uint16_t &volume)
     {
         snd_mixer_t *mixerHandle;
         snd_mixer_open(&mixerHandle, 0);
@@ -62,50 +73,580 @@ namespace speaker
     }
 #endif
     
-    void initialize(const std::string &modelPath, const ModelConfig &modelConfig, const uint16_t &numThreads, const std::string &_audioDeviceName, const std::string &_audioMixerName)
+    // 预先创建定长输入张量并绑定到IoBinding
+    void Speaker::initializeContext(InferenceWorker &worker)
+    {
+        InferenceContext &context = worker.context;
+        context.memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+        context.runOptions = Ort::RunOptions();
+        context.binding = Ort::IoBinding(worker.session.session);
+        context.phonemeIds.clear();
+        context.phonemeIdsShape[1] = 0;
+        context.phonemeIdsTensor = Ort::Value(nullptr);
+
+        const int64_t lengthShape[] = {1};
+        const int64_t scalesShape[] = {(int64_t)context.scales.size()};
+        context.phonemeIdsLengthTensor = Ort::Value::CreateTensor<int64_t>(
+            context.memoryInfo, context.phonemeIdsLength.data(), context.phonemeIdsLength.size(), lengthShape, 1);
+        context.scalesTensor = Ort::Value::CreateTensor<float>(
+            context.memoryInfo, context.scales.data(), context.scales.size(), scalesShape, 1);
+        context.binding.BindInput("input_lengths", context.phonemeIdsLengthTensor);
+        context.binding.BindInput("scales", context.scalesTensor);
+        if (!model.config.singleSpeaker)
+        {
+            context.speakerIdTensor = Ort::Value::CreateTensor<int64_t>(
+                context.memoryInfo, context.speakerId.data(), context.speakerId.size(), lengthShape, 1);
+            context.binding.BindInput("sid", context.speakerIdTensor);
+        }
+        // 输出长度取决于时长预测结果无法预知，绑定到CPU设备由会话分配器（启用内存池时为arena）分配；
+        // 拆分导出时主模型输出潜变量z，由流与声码器模型解码为音频
+        context.binding.BindOutput(incremental() ? "z" : "output", context.memoryInfo);
+    }
+
+    // 写入音素ID，输入长度变化到新的分桶时才重建输入张量
+    void Speaker::bindPhonemeIds(InferenceContext &context, const PhonemeIdsView &phonemeIds)
+    {
+        int64_t length = (int64_t)phonemeIds.size();
+        int64_t paddedLength = length;
+        uint32_t bucketSize = model.config.phonemeBucketSize;
+        if (bucketSize > 0)
+        {
+            paddedLength = (length + bucketSize - 1) / bucketSize * bucketSize;
+        }
+        if (paddedLength != context.phonemeIdsShape[1])
+        {
+            context.phonemeIds.resize(paddedLength);
+            context.phonemeIdsShape[1] = paddedLength;
+            context.phonemeIdsTensor = Ort::Value::CreateTensor<int64_t>(
+                context.memoryInfo,
+                context.phonemeIds.data(),
+                context.phonemeIds.size(),
+                context.phonemeIdsShape.data(),
+                context.phonemeIdsShape.size());
+            context.binding.BindInput("input", context.phonemeIdsTensor);
+        }
+        // 补齐部分填充空白符，实际长度由input_lengths屏蔽
+        phonemeIds.copyTo(context.phonemeIds.data());
+        std::fill(context.phonemeIds.begin() + length, context.phonemeIds.end(), 0);
+        context.phonemeIdsLength[0] = length;
+    }
+
+    // 创建推理单元的会话与推理上下文，cpus非空时推理线程绑定到这些核心
+    void Speaker::initializeWorker(InferenceWorker &worker, const std::string &modelPath, const std::vector<int> &cpus, const uint16_t &numThreads)
+    {
+        worker.session.runtime = Runtime::get();
+        worker.runCpus.clear();
+        if (!cpus.empty())
+        {
+            // Run的调用线程作为第一个推理线程，其余线程由ORT按亲和性配置绑定
+            worker.session.options.SetIntraOpNumThreads(cpus.size());
+            if (cpus.size() > 1)
+            {
+                worker.session.options.AddConfigEntry("session.intra_op_thread_affinities", formatIntraOpAffinities(cpus).c_str());
+            }
+            worker.runCpus.push_back(cpus.front());
+        }
+        else if (numThreads > 0)
+        {
+            worker.session.options.SetIntraOpNumThreads(numThreads);
+        }
+        worker.session.options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        worker.session.options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+        // 内存池与内存复用模式仅在输入形状可复现（分桶）时收益明显，默认关闭
+        if (!model.config.memoryArena)
+        {
+            worker.session.options.DisableCpuMemArena();
+            worker.session.options.DisableMemPattern();
+        }
+        worker.session.options.DisableProfiling();
+        // 各单元的会话共享预打包权重，多会话不重复占用权重内存
+        Runtime &runtime = *worker.session.runtime;
+        worker.session.session = createCachedSession(runtime.env, modelPath, worker.session.options, runtime.prepackedWeights, model.config.optimizedModelCacheDir);
+        if (incremental())
+        {
+            worker.decoder.runtime = worker.session.runtime;
+            worker.decoder.options = worker.session.options.Clone();
+            worker.decoder.session = createCachedSession(runtime.env, model.config.decoderModelPath, worker.decoder.options, runtime.prepackedWeights, model.config.optimizedModelCacheDir);
+        }
+        initializeContext(worker);
+    }
+
+    void Speaker::initialize(const std::string &modelPath, const ModelConfig &modelConfig, const uint16_t &numThreads, const std::string &_audioDeviceName, const std::string &_audioMixerName, const PlaybackConfig &playbackConfig, const CacheConfig &cacheConfig, const PlacementConfig &placementConfig)
     {
         model.config = modelConfig;
-        model.session.env = Ort::Env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "speaker");
-        model.session.env.DisableTelemetryEvents();
-        if (numThreads > 0)
-        {
-            model.session.options.SetIntraOpNumThreads(numThreads);
-        }
-        model.session.options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        model.session.options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
-        model.session.options.DisableCpuMemArena();
-        model.session.options.DisableMemPattern();
-        model.session.options.DisableProfiling();
-        model.session.session = Ort::Session(model.session.env, modelPath.c_str(), model.session.options);
+        // 大小核架构下推理线程固定在同一簇，避免线程落在小核上拖慢整体推理；多会话时各会话分得簇内一组核心
+        placement = planThreadPlacement(readCpuClusters(), numThreads, placementConfig);
+        std::cerr << "speaker thread placement: " << placement.describe() << std::endl;
+        // 各路径统一固定增益（逐段峰值归一化会使分块与整句响度不一致），未标定增益时按模型输出满刻度±1的名义增益；
+        // 限幅阈值留0.3dB余量，避免int16截断后触顶
+        limiterConfig.gain = model.config.outputGain > 0.0f ? model.config.outputGain : model.config.maxWavValue;
+        limiterConfig.threshold = model.config.maxWavValue * 0.966f;
+        limiterConfig.lookahead = std::max<uint32_t>(1, model.config.sampleRate * model.config.limiterLookahead / 1000);
+        limiterConfig.release = model.config.sampleRate * model.config.limiterRelease / 1000;
+        size_t sessions = placement.sessionCpus.empty() ? std::max<uint16_t>(1, placementConfig.sessions) : placement.sessionCpus.size();
+        model.workers.clear();
+        for (size_t i = 0; i < sessions; i++)
+        {
+            model.workers.push_back(std::unique_ptr<InferenceWorker>(new InferenceWorker()));
+            initializeWorker(*model.workers.back(), modelPath, placement.sessionCpus.empty() ? std::vector<int>() : placement.sessionCpus[i], numThreads);
+            if (model.config.warmup)
+            {
+                warmUp(*model.workers.back());
+            }
+        }
         audioDeviceName = std::move(_audioDeviceName);
         audioMixerName = std::move(_audioMixerName);
-#ifdef USE_ALSA
-        alsaOpen();
-#endif
+        PlaybackConfig config = playbackConfig;
+        config.sampleRate = model.config.sampleRate;
+        config.cpus = placement.audioCpus;
+        try
+        {
+            playback.start(createAudioSink(audioDeviceName), config);
+        }
+        catch (const std::exception &e)
+        {
+            // 无声卡或未启用ALSA时仍可仅做合成，播放退化为空输出端
+            std::cerr << "speaker audio device unavailable, fallback to null: " << e.what() << std::endl;
+            playback.start(std::make_unique<NullSink>(), config);
+            audioDeviceName = "null";
+        }
+        utterances.setCapacity(config.queueLength);
+        lookaheadSamples = static_cast<uint64_t>(config.sampleRate) * config.lookaheadDuration / 1000;
+        // 模型内容哈希、采样率与输出增益作为指纹（拆分模型另含解码模型与解码窗口），原路径重新导出模型或更改响度设置后持久化缓存自动失效；
+        // 指纹仅用于持久化文件，未启用时不读取模型
+        uint64_t fingerprint = 0;
+        if (!cacheConfig.filePath.empty())
+        {
+            std::ostringstream text;
+            text << std::hex << hashFile(modelPath) << ":" << std::dec << model.config.sampleRate << ":gain=" << limiterConfig.gain;
+            if (incremental())
+            {
+                text << ":decoder=" << std::hex << hashFile(model.config.decoderModelPath) << std::dec;
+                text << ":window=" << model.config.decodeWindow << "/" << model.config.decodeContext;
+            }
+            std::string fingerprintText = text.str();
+            fingerprint = SynthesisCache::hash(fingerprintText.data(), fingerprintText.size());
+        }
+        cache.open(cacheConfig, fingerprint);
+        if (!model.config.frontendDictPath.empty())
+        {
+            frontend.load(model.config.frontendDictPath, model.config.symbols);
+        }
+        if (!utteranceThread.joinable())
+        {
+            utteranceThread = std::thread(&Speaker::processUtterances, this);
+            completionThread = std::thread(&Speaker::processCompletions, this);
+        }
+    }
+
+    Speaker::~Speaker()
+    {
+        if (!utteranceThread.joinable())
+        {
+            return;
+        }
+        std::vector<std::shared_ptr<Utterance>> removed;
+        std::vector<PlaybackRange> skips;
+        bool writingCancelled = false;
+        utterances.close(removed, skips, writingCancelled);
+        applyCancellation(removed, skips, writingCancelled);
+        utteranceThread.join();
+        completionThread.join();
+    }
+
+    // 以代表性长度的输入预先推理一次，完成内存分配与线程池启动，首次合成即达到稳态延迟
+    void Speaker::warmUp(InferenceWorker &worker)
+    {
+        const size_t WARMUP_PHONEME_LENGTH = 64;
+        size_t symbolCount = std::max<size_t>(model.config.symbols.size(), 2);
+        std::vector<int64_t> phonemeIds(WARMUP_PHONEME_LENGTH, 0);
+        for (size_t i = 1; i < phonemeIds.size(); i += 2)
+        {
+            phonemeIds[i] = 1 + (i / 2) % (symbolCount - 1);
+        }
+        std::vector<int16_t> audioBuffer;
+        SynthesisResult result;
+        infer(worker, phonemeIds, 0, 1.0f, audioBuffer, result);
+        std::cerr << "speaker warm-up: " << result.inferDuration << "ms" << std::endl;
     }
 
-    void setVolume(const uint16_t &volume)
+    void Speaker::textToPhonemeIds(const std::string &text, std::vector<int64_t> &phonemeIds) const
     {
+        frontend.textToPhonemeIds(text, phonemeIds);
+    }
+
+    bool Speaker::hasTextFrontend() const
+    {
+        return frontend.loaded();
+    }
+
+    void Speaker::setVolume(const uint16_t &volume)
+    {
+        // 空输出端与WAV文件输出端无混音器
+        if (audioDeviceName == "null" || audioDeviceName.rfind("wav:", 0) == 0)
+        {
+            return;
+        }
 #ifdef USE_ALSA
-        alsaSetVolume(volume);
+        alsaSetVolume(audioDeviceName, audioMixerName, volume);
 #else
         throw std::runtime_error("please USE_ALSA!");
 #endif
     }
 
-    void synthesize(std::vector<int64_t> &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<int16_t> &audioBuffer, SynthesisResult &result)
+    CacheStats Speaker::getCacheStats() const
+    {
+        return cache.stats();
+    }
+
+    // 写入输入并执行主模型推理（调用方需持有推理上下文锁），返回推理时长（毫秒）
+    int Speaker::runContext(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate)
+    {
+        InferenceContext &context = worker.context;
+        bindPhonemeIds(context, phonemeIds);
+        context.scales[0] = model.config.noiseScale;
+        context.scales[1] = model.config.lengthScale / speechRate;
+        context.scales[2] = model.config.noiseW;
+        context.speakerId[0] = speakerId;
+
+        ScopedThreadAffinity affinity(worker.runCpus);
+        auto startTime = std::chrono::steady_clock::now();
+        beginRun(worker);
+        try
+        {
+            worker.session.session.Run(context.runOptions, context.binding);
+        }
+        catch (...)
+        {
+            endRun(worker);
+            throw;
+        }
+        endRun(worker);
+        auto inferDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime);
+        return inferDuration.count() * 1000;
+    }
+
+    // 执行vits推理，音频追加到audioBuffer
+    void Speaker::infer(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<int16_t> &audioBuffer, SynthesisResult &result)
+    {
+        if (incremental())
+        {
+            // 拆分模型整句合成：编码后单窗口解码全部潜变量帧
+            std::vector<float> latent, window, audio;
+            int64_t channels = 0;
+            result.inferDuration = encode(worker, phonemeIds, speakerId, speechRate, latent, channels);
+            int64_t frames = channels > 0 ? (int64_t)latent.size() / channels : 0;
+            if (frames > 0)
+            {
+                result.inferDuration += decode(worker, latent, channels, 0, frames, speakerId, window, audio);
+            }
+            result.firstChunkDuration = result.inferDuration;
+            result.audioDuration = ((double)audio.size() / (double)model.config.sampleRate) * 1000;
+            size_t offset = audioBuffer.size();
+            audioBuffer.resize(offset + audio.size());
+            convertAudio(audio.data(), audio.size(), audioBuffer.data() + offset);
+            return;
+        }
+
+        InferenceContext &context = worker.context;
+        std::lock_guard<std::mutex> lock(context.mutex);
+        result.inferDuration = runContext(worker, phonemeIds, speakerId, speechRate);
+        result.firstChunkDuration = result.inferDuration;
+
+        auto outputTensors = context.binding.GetOutputValues();
+
+        if ((outputTensors.size() != 1) || (!outputTensors.front().IsTensor()))
+        {
+            throw std::runtime_error("invalid output tensors");
+        }
+
+        const float *audio = outputTensors.front().GetTensorData<float>();
+        auto audioShape = outputTensors.front().GetTensorTypeAndShapeInfo().GetShape();
+        int64_t audioSamples = audioShape[audioShape.size() - 1];
+        result.audioDuration = ((double)audioSamples / (double)model.config.sampleRate) * 1000;
+
+        // 直接转换到预留好的缓冲区
+        size_t offset = audioBuffer.size();
+        audioBuffer.resize(offset + audioSamples);
+        convertAudio(audio, audioSamples, audioBuffer.data() + offset);
+    }
+
+    // 拆分模型编码：执行文本编码器与时长预测，潜变量z（形状{1, channels, frames}）复制到latent，
+    // 推理上下文锁仅在推理期间持有，后续逐窗口解码时其它调用可穿插推理
+    int Speaker::encode(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<float> &latent, int64_t &channels)
+    {
+        InferenceContext &context = worker.context;
+        std::lock_guard<std::mutex> lock(context.mutex);
+        int inferDuration = runContext(worker, phonemeIds, speakerId, speechRate);
+
+        auto outputTensors = context.binding.GetOutputValues();
+        if ((outputTensors.size() != 1) || (!outputTensors.front().IsTensor()))
+        {
+            throw std::runtime_error("invalid output tensors");
+        }
+        auto latentShape = outputTensors.front().GetTensorTypeAndShapeInfo().GetShape();
+        if (latentShape.size() != 3 || latentShape[0] != 1)
+        {
+            throw std::runtime_error("invalid latent shape");
+        }
+        channels = latentShape[1];
+        const float *data = outputTensors.front().GetTensorData<float>();
+        latent.assign(data, data + channels * latentShape[2]);
+        return inferDuration;
+    }
+
+    // 拆分模型解码：以流与声码器模型解码潜变量帧[begin, end)，音频写入audio，返回推理时长（毫秒）
+    int Speaker::decode(InferenceWorker &worker, const std::vector<float> &latent, int64_t channels, int64_t begin, int64_t end, const uint16_t &speakerId, std::vector<float> &window, std::vector<float> &audio)
+    {
+        int64_t frames = (int64_t)latent.size() / channels;
+        int64_t length = end - begin;
+        // 潜变量按通道连续存储，窗口需逐通道复制
+        window.resize(channels * length);
+        for (int64_t channel = 0; channel < channels; channel++)
+        {
+            std::copy(latent.begin() + channel * frames + begin, latent.begin() + channel * frames + end, window.begin() + channel * length);
+        }
+
+        InferenceContext &context = worker.context;
+        std::lock_guard<std::mutex> lock(context.mutex);
+        std::array<int64_t, 3> latentShape{1, channels, length};
+        std::array<int64_t, 1> speakerIds{speakerId};
+        const int64_t speakerIdShape[] = {1};
+        std::vector<Ort::Value> inputTensors;
+        inputTensors.push_back(Ort::Value::CreateTensor<float>(
+            context.memoryInfo, window.data(), window.size(), latentShape.data(), latentShape.size()));
+        if (!model.config.singleSpeaker)
+        {
+            inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
+                context.memoryInfo, speakerIds.data(), speakerIds.size(), speakerIdShape, 1));
+        }
+        std::array<const char *, 2> inputNames = {"z", "sid"};
+        std::array<const char *, 1> outputNames = {"output"};
+
+        ScopedThreadAffinity affinity(worker.runCpus);
+        auto startTime = std::chrono::steady_clock::now();
+        beginRun(worker);
+        std::vector<Ort::Value> outputTensors;
+        try
+        {
+            outputTensors = worker.decoder.session.Run(
+                context.runOptions,
+                inputNames.data(),
+                inputTensors.data(),
+                inputTensors.size(),
+                outputNames.data(),
+                outputNames.size());
+        }
+        catch (...)
+        {
+            endRun(worker);
+            throw;
+        }
+        endRun(worker);
+        auto inferDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime);
+
+        if ((outputTensors.size() != 1) || (!outputTensors.front().IsTensor()))
+        {
+            throw std::runtime_error("invalid output tensors");
+        }
+        const float *data = outputTensors.front().GetTensorData<float>();
+        auto audioShape = outputTensors.front().GetTensorTypeAndShapeInfo().GetShape();
+        audio.assign(data, data + audioShape[audioShape.size() - 1]);
+        return inferDuration.count() * 1000;
+    }
+
+    // 拆分模型增量合成：编码一次后按窗口解码潜变量，窗口两侧附加重叠上下文帧参与计算、输出时裁去，
+    // 各窗口音频经同一流式响度级连续处理后交付；回调返回false时停止并返回false
+    bool Speaker::inferIncremental(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const WindowCallback &onWindow)
+    {
+        std::vector<float> latent;
+        int64_t channels = 0;
+        int encodeDuration = encode(worker, phonemeIds, speakerId, speechRate, latent, channels);
+        int64_t frames = channels > 0 ? (int64_t)latent.size() / channels : 0;
+        if (frames == 0)
+        {
+            return true;
+        }
+
+        int64_t windowFrames = std::max<int64_t>(1, model.config.decodeWindow);
+        int64_t contextFrames = model.config.decodeContext;
+        StreamingLimiter &limiter = threadLimiter();
+        std::vector<float> window, audio;
+        std::vector<int16_t> windowBuffer;
+        for (int64_t begin = 0; begin < frames; begin += windowFrames)
+        {
+            int64_t end = std::min(frames, begin + windowFrames);
+            int64_t decodeBegin = std::max<int64_t>(0, begin - contextFrames);
+            int64_t decodeEnd = std::min(frames, end + contextFrames);
+            SynthesisResult windowResult{};
+            windowResult.inferDuration = decode(worker, latent, channels, decodeBegin, decodeEnd, speakerId, window, audio);
+            if (begin == 0)
+            {
+                windowResult.inferDuration += encodeDuration;
+            }
+            windowResult.firstChunkDuration = windowResult.inferDuration;
+
+            // 声码器输出与潜变量帧严格按帧移对齐，据此裁去上下文部分
+            size_t hopSamples = audio.size() / (decodeEnd - decodeBegin);
+            size_t offset = (begin - decodeBegin) * hopSamples;
+            size_t samples = std::min(audio.size() - offset, (end - begin) * hopSamples);
+            bool last = end == frames;
+            windowBuffer.resize(samples + limiter.latency());
+            size_t written = limiter.process(audio.data() + offset, samples, windowBuffer.data());
+            if (last)
+            {
+                written += limiter.flush(windowBuffer.data() + written);
+            }
+            windowBuffer.resize(written);
+            windowResult.audioDuration = ((double)written / (double)model.config.sampleRate) * 1000;
+            if (!onWindow(windowBuffer, windowResult, last))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 当前线程复用的流式响度级：同一推理单元可被多个调用并发使用（批量推理与增量解码的窗口间不持有推理上下文锁），
+    // 响度级状态按线程持有；按本实例配置复位，延迟线长度不变时不重新分配
+    StreamingLimiter &Speaker::threadLimiter() const
+    {
+        static thread_local StreamingLimiter limiter;
+        limiter.configure(limiterConfig);
+        return limiter;
+    }
+
+    // 模型输出转换为int16：乘以固定增益后经流式响度级，各段响度一致且无需先求整段峰值
+    void Speaker::convertAudio(const float *audio, size_t samples, int16_t *audioBuffer) const
+    {
+        StreamingLimiter &limiter = threadLimiter();
+        size_t written = limiter.process(audio, samples, audioBuffer);
+        limiter.flush(audioBuffer + written);
+    }
+
+    void Speaker::synthesize(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<int16_t> &audioBuffer, SynthesisResult &result)
+    {
+        synthesize(*model.workers.front(), phonemeIds, speakerId, speechRate, audioBuffer, result);
+    }
+
+    void Speaker::synthesize(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, std::vector<int16_t> &audioBuffer, SynthesisResult &result)
+    {
+        if (!cache.enabled())
+        {
+            infer(worker, phonemeIds, speakerId, speechRate, audioBuffer, result);
+            return;
+        }
+        std::string key = cacheKey(phonemeIds, speakerId, speechRate, false);
+        size_t offset = audioBuffer.size();
+        if (lookupCache(key, audioBuffer, result))
+        {
+            return;
+        }
+        infer(worker, phonemeIds, speakerId, speechRate, audioBuffer, result);
+        cache.insert(key, audioBuffer.data() + offset, audioBuffer.size() - offset);
+    }
+
+    // 合成缓存键：拆分模型整句解码与按窗口增量解码的输出在窗口边界处略有差异，键中区分解码方式
+    std::string Speaker::cacheKey(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, bool windowed) const
+    {
+        std::string key = SynthesisCache::makeKey(phonemeIds, speakerId, speechRate, model.config.noiseScale, model.config.lengthScale, model.config.noiseW);
+        if (incremental())
+        {
+            key.push_back(windowed ? 'w' : 'f');
+        }
+        return key;
+    }
+
+    // 查询合成缓存，命中时音频追加到audioBuffer并以查询耗时作为推理时长
+    bool Speaker::lookupCache(const std::string &key, std::vector<int16_t> &audioBuffer, SynthesisResult &result)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        size_t offset = audioBuffer.size();
+        if (!cache.lookup(key, audioBuffer))
+        {
+            return false;
+        }
+        auto lookupDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime);
+        result.inferDuration = lookupDuration.count() * 1000;
+        result.firstChunkDuration = result.inferDuration;
+        result.audioDuration = ((double)(audioBuffer.size() - offset) / (double)model.config.sampleRate) * 1000;
+        return true;
+    }
+
+    // 单句增量合成：缓存命中时整句交付，否则逐窗口交付并在整句完成后写入缓存（缓存不含拼接处淡入淡出）
+    bool Speaker::synthesizeIncremental(InferenceWorker &worker, const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const bool &fadeIn, const bool &fadeOut, const ChunkCallback &onChunk)
+    {
+        std::string key;
+        if (cache.enabled())
+        {
+            key = cacheKey(phonemeIds, speakerId, speechRate, true);
+            std::vector<int16_t> audioBuffer;
+            SynthesisResult result;
+            if (lookupCache(key, audioBuffer, result))
+            {
+                applyFade(audioBuffer, fadeIn, fadeOut);
+                return onChunk(audioBuffer, result);
+            }
+        }
+        std::vector<int16_t> audioBuffer;
+        bool first = true;
+        bool completed = inferIncremental(worker, phonemeIds, speakerId, speechRate, [&](std::vector<int16_t> &window, const SynthesisResult &windowResult, bool last)
+                                          {
+                                              if (cache.enabled())
+                                              {
+                                                  audioBuffer.insert(audioBuffer.end(), window.begin(), window.end());
+                                              }
+                                              applyFade(window, fadeIn && first, fadeOut && last);
+                                              first = false;
+                                              return onChunk(window, windowResult); });
+        if (completed && cache.enabled())
+        {
+            cache.insert(key, audioBuffer.data(), audioBuffer.size());
+        }
+        return completed;
+    }
+
+    // 去除批量输出中补齐产生的尾部静音，保留少量余量避免截断尾音
+    size_t Speaker::trimPadding(const float *audio, size_t samples) const
+    {
+        float threshold = std::max(0.01f, peakAbs(audio, samples)) * 0.002f;
+        size_t length = samples;
+        while (length > 0 && std::fabs(audio[length - 1]) < threshold)
+        {
+            length--;
+        }
+        size_t margin = static_cast<size_t>(model.config.sampleRate) * 10 / 1000;
+        return std::min(samples, length + margin);
+    }
+
+    // 将indices指定的若干句补齐为一批执行单次推理
+    void Speaker::inferBatch(InferenceWorker &worker, const std::vector<PhonemeIdsView> &phonemeIdsBatch, const std::vector<size_t> &indices, const uint16_t &speakerId, const float &speechRate, std::vector<std::vector<int16_t>> &audioBuffers, SynthesisResult &result)
     {
         auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
 
-        std::vector<int64_t> phonemeIdsLength{(int64_t)phonemeIds.size()};
+        int64_t batchSize = (int64_t)indices.size();
+        size_t maxLength = 0;
+        for (const size_t &index : indices)
+        {
+            maxLength = std::max(maxLength, phonemeIdsBatch[index].size());
+        }
+        // 补齐部分填充空白符，实际长度由input_lengths屏蔽
+        std::vector<int64_t> phonemeIds(batchSize * maxLength, 0);
+        std::vector<int64_t> phonemeIdsLength(batchSize);
+        for (int64_t i = 0; i < batchSize; i++)
+        {
+            const PhonemeIdsView &sequence = phonemeIdsBatch[indices[i]];
+            sequence.copyTo(phonemeIds.data() + i * maxLength);
+            phonemeIdsLength[i] = (int64_t)sequence.size();
+        }
         std::vector<float> scales{
             model.config.noiseScale,
             model.config.lengthScale / speechRate,
             model.config.noiseW};
-        std::vector<int64_t> speakerIdVector{ speakerId };
+        std::vector<int64_t> speakerIds(batchSize, speakerId);
 
         std::vector<Ort::Value> inputTensors;
-        std::vector<int64_t> phonemeIdsShape{1, (int64_t)phonemeIds.size()};
+        std::vector<int64_t> phonemeIdsShape{batchSize, (int64_t)maxLength};
         inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
             memoryInfo,
             phonemeIds.data(),
@@ -113,13 +654,13 @@ namespace speaker
             phonemeIdsShape.data(),
             phonemeIdsShape.size()));
 
-        std::vector<int64_t> phomemeIdsLengthShape{(int64_t)phonemeIdsLength.size()};
+        std::vector<int64_t> phonemeIdsLengthShape{batchSize};
         inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
             memoryInfo,
             phonemeIdsLength.data(),
             phonemeIdsLength.size(),
-            phomemeIdsLengthShape.data(),
-            phomemeIdsLengthShape.size()));
+            phonemeIdsLengthShape.data(),
+            phonemeIdsLengthShape.size()));
 
         std::vector<int64_t> scalesShape{(int64_t)scales.size()};
         inputTensors.push_back(Ort::Value::CreateTensor<float>(
@@ -131,21 +672,21 @@ namespace speaker
 
         if (!model.config.singleSpeaker)
         {
-            std::vector<int64_t> speakerIdShape{(int64_t)speakerIdVector.size()};
+            std::vector<int64_t> speakerIdShape{batchSize};
             inputTensors.push_back(Ort::Value::CreateTensor<int64_t>(
                 memoryInfo,
-                speakerIdVector.data(),
-                speakerIdVector.size(),
+                speakerIds.data(),
+                speakerIds.size(),
                 speakerIdShape.data(),
                 speakerIdShape.size()));
         }
-        
 
         std::array<const char *, 4> inputNames = {"input", "input_lengths", "scales", "sid"};
         std::array<const char *, 1> outputNames = {"output"};
 
+        ScopedThreadAffinity affinity(worker.runCpus);
         auto startTime = std::chrono::steady_clock::now();
-        auto outputTensors = model.session.session.Run(
+        auto outputTensors = worker.session.session.Run(
             Ort::RunOptions{nullptr},
             inputNames.data(),
             inputTensors.data(),
@@ -160,74 +701,848 @@ namespace speaker
         }
 
         auto inferDuration = std::chrono::duration<double>(endTime - startTime);
-        result.inferDuration = inferDuration.count() * 1000;
+        result.inferDuration += inferDuration.count() * 1000;
 
+        // 输出形状为{batch, 1, samples}，短句尾部为补齐部分
         const float *audio = outputTensors.front().GetTensorData<float>();
         auto audioShape = outputTensors.front().GetTensorTypeAndShapeInfo().GetShape();
-        int64_t audioSamples = audioShape[audioShape.size() - 1];
-        result.audioDuration = ((double)audioSamples / (double)model.config.sampleRate) * 1000;
+        size_t audioSamples = (size_t)audioShape[audioShape.size() - 1];
+        for (int64_t i = 0; i < batchSize; i++)
+        {
+            const float *itemAudio = audio + i * audioSamples;
+            size_t length = trimPadding(itemAudio, audioSamples);
+            std::vector<int16_t> &audioBuffer = audioBuffers[indices[i]];
+            audioBuffer.resize(length);
+            convertAudio(itemAudio, length, audioBuffer.data());
+        }
+    }
+
+    void Speaker::synthesizeBatch(const std::vector<PhonemeIdsView> &phonemeIdsBatch, const uint16_t &speakerId, const float &speechRate, std::vector<std::vector<int16_t>> &audioBuffers, SynthesisResult &result)
+    {
+        audioBuffers.assign(phonemeIdsBatch.size(), std::vector<int16_t>());
+        result.inferDuration = 0;
+        result.audioDuration = 0;
+        result.firstChunkDuration = 0;
+        auto startTime = std::chrono::steady_clock::now();
 
-        float maxAudioValue = 0.01f;
-        for (int64_t i = 0; i < audioSamples; i++)
+        // 缓存命中的句子无需推理
+        std::vector<std::string> keys(phonemeIdsBatch.size());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < phonemeIdsBatch.size(); i++)
         {
-            float audioValue = abs(audio[i]);
-            if (audioValue > maxAudioValue)
+            if (cache.enabled())
+            {
+                keys[i] = cacheKey(phonemeIdsBatch[i], speakerId, speechRate, false);
+                if (cache.lookup(keys[i], audioBuffers[i]))
+                {
+                    continue;
+                }
+            }
+            if (phonemeIdsBatch[i].empty())
             {
-                maxAudioValue = audioValue;
+                continue;
             }
+            pending.push_back(i);
         }
 
-        audioBuffer.reserve(audioSamples);
+        // 按长度排序后分批，减少补齐带来的无效计算
+        std::stable_sort(pending.begin(), pending.end(), [&](const size_t &a, const size_t &b)
+                         { return phonemeIdsBatch[a].size() < phonemeIdsBatch[b].size(); });
+        // 拆分模型的潜变量帧数各句不同，逐句推理
+        size_t maxBatchSize = incremental() ? 1 : std::max<size_t>(1, model.config.maxBatchSize);
+        for (size_t begin = 0; begin < pending.size(); begin += maxBatchSize)
+        {
+            std::vector<size_t> indices(pending.begin() + begin, pending.begin() + std::min(begin + maxBatchSize, pending.size()));
+            if (incremental())
+            {
+                SynthesisResult itemResult;
+                infer(*model.workers.front(), phonemeIdsBatch[indices.front()], speakerId, speechRate, audioBuffers[indices.front()], itemResult);
+                result.inferDuration += itemResult.inferDuration;
+            }
+            else
+            {
+                inferBatch(*model.workers.front(), phonemeIdsBatch, indices, speakerId, speechRate, audioBuffers, result);
+            }
+            if (cache.enabled())
+            {
+                for (const size_t &index : indices)
+                {
+                    cache.insert(keys[index], audioBuffers[index].data(), audioBuffers[index].size());
+                }
+            }
+        }
 
-        float audioValueScale = (model.config.maxWavValue / std::max(0.01f, maxAudioValue));
-        for (int64_t i = 0; i < audioSamples; i++)
+        size_t totalSamples = 0;
+        for (const std::vector<int16_t> &audioBuffer : audioBuffers)
         {
-            int16_t intAudioValue = static_cast<int16_t>(
-                std::clamp(audio[i] * audioValueScale,
-                           static_cast<float>(std::numeric_limits<int16_t>::min()),
-                           static_cast<float>(std::numeric_limits<int16_t>::max())));
+            totalSamples += audioBuffer.size();
+        }
+        result.audioDuration = ((double)totalSamples / (double)model.config.sampleRate) * 1000;
+        auto totalDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime);
+        result.firstChunkDuration = totalDuration.count() * 1000;
+    }
 
-            audioBuffer.push_back(intAudioValue);
+    void Speaker::splitPhonemeIds(const PhonemeIdsView &phonemeIds, std::vector<std::vector<int64_t>> &chunks) const
+    {
+        const std::vector<int64_t> &pauseIds = model.config.pauseIds;
+        std::vector<int64_t> chunk;
+        for (size_t i = 0; i < phonemeIds.size(); i++)
+        {
+            int64_t phonemeId = phonemeIds[i];
+            chunk.push_back(phonemeId);
+            bool isPause = std::find(pauseIds.begin(), pauseIds.end(), phonemeId) != pauseIds.end();
+            if (isPause && chunk.size() >= model.config.minChunkLength)
+            {
+                chunks.push_back(std::move(chunk));
+                chunk.clear();
+            }
         }
-        
-        for (std::size_t i = 0; i < outputTensors.size(); i++)
+        if (chunk.empty())
         {
-            Ort::detail::OrtRelease(outputTensors[i].release());
+            return;
         }
+        // 末尾过短的块并入上一块，避免单独合成几个音素
+        if (!chunks.empty() && chunk.size() < model.config.minChunkLength)
+        {
+            chunks.back().insert(chunks.back().end(), chunk.begin(), chunk.end());
+        }
+        else
+        {
+            chunks.push_back(std::move(chunk));
+        }
+    }
 
-        for (std::size_t i = 0; i < inputTensors.size(); i++)
+    // 分块拼接处淡入淡出
+    void Speaker::applyFade(std::vector<int16_t> &audioBuffer, const bool &fadeIn, const bool &fadeOut) const
+    {
+        size_t fadeSamples = std::min<size_t>(
+            static_cast<size_t>(model.config.sampleRate) * model.config.fadeDuration / 1000,
+            audioBuffer.size() / 2);
+        if (fadeSamples == 0)
         {
-            Ort::detail::OrtRelease(inputTensors[i].release());
+            return;
+        }
+        for (size_t i = 0; i < fadeSamples; i++)
+        {
+            float gain = static_cast<float>(i) / fadeSamples;
+            if (fadeIn)
+            {
+                audioBuffer[i] = static_cast<int16_t>(audioBuffer[i] * gain);
+            }
+            if (fadeOut)
+            {
+                size_t j = audioBuffer.size() - 1 - i;
+                audioBuffer[j] = static_cast<int16_t>(audioBuffer[j] * gain);
+            }
         }
     }
 
-    void say(std::vector<int64_t> &phonemeIds, const uint16_t &speakerId, const float &speechRate, const bool &block, SynthesisResult &result) {
-#ifdef USE_ALSA
-        snd_pcm_state_t pcmHandleState = snd_pcm_state(pcmHandle);
-        std::cout << pcmHandleState << std::endl;
-        switch(pcmHandleState) {
-            case SND_PCM_STATE_SETUP:
-                snd_pcm_prepare(pcmHandle);
-            break;
-            case SND_PCM_STATE_RUNNING:
-            case SND_PCM_STATE_DRAINING:
-                snd_pcm_drop(pcmHandle);
-                snd_pcm_reset(pcmHandle);
-                snd_pcm_prepare(pcmHandle);
-            break;
-            case SND_PCM_STATE_XRUN:
-            case SND_PCM_STATE_PAUSED:
-                snd_pcm_reset(pcmHandle);
-                snd_pcm_prepare(pcmHandle);
+    void Speaker::synthesizeStream(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const ChunkCallback &onChunk, SynthesisResult &result)
+    {
+        std::vector<std::vector<int64_t>> chunks;
+        splitPhonemeIds(phonemeIds, chunks);
+
+        result.inferDuration = 0;
+        result.audioDuration = 0;
+        result.firstChunkDuration = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        bool delivered = false;
+        auto deliver = [&](std::vector<int16_t> &chunk, const SynthesisResult &chunkResult)
+        {
+            result.inferDuration += chunkResult.inferDuration;
+            result.audioDuration += chunkResult.audioDuration;
+            if (!delivered)
+            {
+                auto firstChunkDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime);
+                result.firstChunkDuration = firstChunkDuration.count() * 1000;
+                delivered = true;
+            }
+            return onChunk(chunk, chunkResult);
+        };
+
+        if (model.workers.size() > 1 && chunks.size() > 1)
+        {
+            synthesizeParallel(chunks, speakerId, speechRate, deliver);
+            return;
         }
+        InferenceWorker &worker = *model.workers.front();
+        if (incremental())
+        {
+            for (size_t i = 0; i < chunks.size(); i++)
+            {
+                if (!synthesizeIncremental(worker, chunks[i], speakerId, speechRate, i > 0, i + 1 < chunks.size(), deliver))
+                {
+                    break;
+                }
+            }
+            return;
+        }
+
+        // 回调未移走数据时各块复用同一音频缓冲区
         std::vector<int16_t> audioBuffer;
-        synthesize(phonemeIds, speakerId, speechRate, audioBuffer, result);
-        snd_pcm_writei(pcmHandle, audioBuffer.data(), audioBuffer.size());
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            audioBuffer.clear();
+            SynthesisResult chunkResult;
+            synthesize(worker, chunks[i], speakerId, speechRate, audioBuffer, chunkResult);
+            applyFade(audioBuffer, i > 0, i + 1 < chunks.size());
+            if (!deliver(audioBuffer, chunkResult))
+            {
+                break;
+            }
+        }
+    }
+
+    InferenceWorker::~InferenceWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(taskMutex);
+            stopping = true;
+        }
+        taskCondition.notify_all();
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    void InferenceWorker::post(std::function<void()> task)
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        if (!thread.joinable())
+        {
+            thread = std::thread(&InferenceWorker::run, this);
+        }
+        tasks.push_back(std::move(task));
+        taskCondition.notify_one();
+    }
+
+    void InferenceWorker::run()
+    {
+        std::unique_lock<std::mutex> lock(taskMutex);
+        while (true)
+        {
+            taskCondition.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    // 多会话并行分句合成：每个推理单元的常驻线程执行一个合成任务，按顺序领取分句（领先交付位置不超过单元数，避免取消时浪费算力），
+    // 调用线程按原顺序交付各分句的音频块；交付回调返回false时不再领取新分句，进行中的增量解码在当前窗口后停止
+    void Speaker::synthesizeParallel(const std::vector<std::vector<int64_t>> &chunks, const uint16_t &speakerId, const float &speechRate, const ChunkCallback &onChunk)
+    {
+        struct Sentence
+        {
+            std::deque<std::vector<int16_t>> chunks;
+            std::deque<SynthesisResult> results;
+            bool done = false;
+            std::exception_ptr error;
+        };
+        std::vector<Sentence> sentences(chunks.size());
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t next = 0;       // 下一个待领取的分句
+        size_t delivering = 0; // 正在交付的分句
+        bool stopped = false;
+        size_t workerCount = std::min(model.workers.size(), chunks.size());
+        bool inUtterance = utteranceInference;
+
+        auto work = [&](InferenceWorker &worker)
+        {
+            // 发音线程派发的推理同样受语句取消控制
+            utteranceInference = inUtterance;
+            while (true)
+            {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [&] { return stopped || next >= chunks.size() || next < delivering + workerCount; });
+                    if (stopped || next >= chunks.size())
+                    {
+                        return;
+                    }
+                    index = next++;
+                }
+                auto push = [&](std::vector<int16_t> &chunk, const SynthesisResult &chunkResult)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    sentences[index].chunks.push_back(std::move(chunk));
+                    sentences[index].results.push_back(chunkResult);
+                    condition.notify_all();
+                    return !stopped;
+                };
+                std::exception_ptr error;
+                try
+                {
+                    bool fadeIn = index > 0;
+                    bool fadeOut = index + 1 < chunks.size();
+                    if (incremental())
+                    {
+                        synthesizeIncremental(worker, chunks[index], speakerId, speechRate, fadeIn, fadeOut, push);
+                    }
+                    else
+                    {
+                        std::vector<int16_t> audioBuffer;
+                        SynthesisResult chunkResult;
+                        synthesize(worker, chunks[index], speakerId, speechRate, audioBuffer, chunkResult);
+                        applyFade(audioBuffer, fadeIn, fadeOut);
+                        push(audioBuffer, chunkResult);
+                    }
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                sentences[index].error = error;
+                sentences[index].done = true;
+                condition.notify_all();
+            }
+        };
+        // 任务引用本函数的局部状态，返回（含异常返回）前须等待全部任务结束
+        std::exception_ptr error;
+        size_t pendingTasks = workerCount; // 已派发未结束的合成任务数
+        for (size_t i = 0; i < workerCount; i++)
+        {
+            InferenceWorker &worker = *model.workers[i];
+            try
+            {
+                worker.post([&work, &worker, &mutex, &condition, &pendingTasks]
+                            {
+                                work(worker);
+                                std::lock_guard<std::mutex> lock(mutex);
+                                pendingTasks--;
+                                condition.notify_all(); });
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+                pendingTasks -= workerCount - i;
+                stopped = true;
+                condition.notify_all();
+                break;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopped && delivering < sentences.size())
+        {
+            Sentence &sentence = sentences[delivering];
+            condition.wait(lock, [&] { return !sentence.chunks.empty() || sentence.done; });
+            if (!sentence.chunks.empty())
+            {
+                std::vector<int16_t> chunk = std::move(sentence.chunks.front());
+                SynthesisResult chunkResult = sentence.results.front();
+                sentence.chunks.pop_front();
+                sentence.results.pop_front();
+                lock.unlock();
+                // 交付回调抛出异常时停止合成，待任务结束后重新抛出
+                bool proceed = false;
+                try
+                {
+                    proceed = onChunk(chunk, chunkResult);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                lock.lock();
+                stopped = !proceed;
+                continue;
+            }
+            if (sentence.error)
+            {
+                error = sentence.error;
+                break;
+            }
+            delivering++;
+            condition.notify_all();
+        }
+        stopped = true;
+        condition.notify_all();
+        condition.wait(lock, [&] { return pendingTasks == 0; });
+        lock.unlock();
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // 分句流式播放：回放线程播放第N块的同时合成第N+1块
+    void Speaker::sayStream(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, SynthesisResult &result)
+    {
+        synthesizeStream(phonemeIds, speakerId, speechRate, [this](std::vector<int16_t> &chunk, const SynthesisResult &chunkResult)
+                         {
+                             playback.enqueue(chunk.data(), chunk.size());
+                             return true; },
+                         result);
+    }
+
+    void Speaker::say(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const bool &block, const bool &stream, SynthesisResult &result) {
+        // 丢弃上一次未播放完的音频，发音队列中的语句一并取消（等待发音线程停止写入后再清空）
+        cancelUtterances();
+        utterances.waitWritten();
+        playback.flush();
+        if (stream)
+        {
+            sayStream(phonemeIds, speakerId, speechRate, result);
+        }
+        else
+        {
+            // 音频缓冲区按线程复用，写入回放队列后即可覆盖
+            static thread_local std::vector<int16_t> audioBuffer;
+            audioBuffer.clear();
+            synthesize(phonemeIds, speakerId, speechRate, audioBuffer, result);
+            playback.enqueue(audioBuffer.data(), audioBuffer.size());
+        }
         if(block)
-            snd_pcm_drain(pcmHandle);
-#else
-        throw std::runtime_error("please USE_ALSA!");
-#endif
+            playback.drain();
+    }
+
+    // 发音队列语句进入推理：当前语句已被取消时直接终止
+    void Speaker::beginRun(InferenceWorker &worker)
+    {
+        if (!utteranceInference)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(terminateMutex);
+        worker.utteranceRunning = true;
+        if (writingUtterance != nullptr && writingUtterance->cancelled)
+        {
+            worker.context.runOptions.SetTerminate();
+        }
+    }
+
+    // 发音队列语句退出推理：清除终止标志，避免影响后续推理（推理上下文锁释放前调用）
+    void Speaker::endRun(InferenceWorker &worker)
+    {
+        if (!utteranceInference)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(terminateMutex);
+        worker.utteranceRunning = false;
+        worker.context.runOptions.UnsetTerminate();
+    }
+
+    // 执行取消：跳过被取消语句已写入的音频，终止发音队列语句进行中的推理（其它调用方的推理不受影响），并通知已移除的语句
+    void Speaker::applyCancellation(std::vector<std::shared_ptr<Utterance>> &removed, const std::vector<PlaybackRange> &skips, bool writingCancelled)
+    {
+        for (const PlaybackRange &range : skips)
+        {
+            playback.skip(range.begin, range.end);
+        }
+        if (writingCancelled)
+        {
+            std::lock_guard<std::mutex> lock(terminateMutex);
+            for (std::unique_ptr<InferenceWorker> &worker : model.workers)
+            {
+                if (worker->utteranceRunning)
+                {
+                    worker->context.runOptions.SetTerminate();
+                }
+            }
+        }
+        for (std::shared_ptr<Utterance> &utterance : removed)
+        {
+            if (utterance->onDone)
+            {
+                utterance->onDone(UtteranceState::Cancelled, utterance->result, 0, "");
+            }
+        }
+    }
+
+    uint64_t Speaker::enqueueUtterance(const PhonemeIdsView &phonemeIds, const uint16_t &speakerId, const float &speechRate, const int &priority, const bool &interrupt, const UtteranceCallback &onDone)
+    {
+        auto utterance = std::make_shared<Utterance>();
+        utterance->priority = priority;
+        utterance->phonemeIds.resize(phonemeIds.size());
+        phonemeIds.copyTo(utterance->phonemeIds.data());
+        utterance->speakerId = speakerId;
+        utterance->speechRate = speechRate;
+        utterance->onDone = onDone;
+        return enqueue(std::move(utterance), interrupt);
+    }
+
+    // 语句加入发音队列，队列已满时抛出异常
+    uint64_t Speaker::enqueue(std::shared_ptr<Utterance> utterance, const bool &interrupt)
+    {
+        if (!utteranceThread.joinable())
+        {
+            throw std::runtime_error("speaker not initialized");
+        }
+        utterance->id = nextUtteranceId++;
+        utterance->enqueueTime = std::chrono::steady_clock::now();
+        uint64_t id = utterance->id;
+        std::vector<std::shared_ptr<Utterance>> removed;
+        std::vector<PlaybackRange> skips;
+        bool writingCancelled = false;
+        if (!utterances.push(std::move(utterance), interrupt, removed, skips, writingCancelled))
+        {
+            throw std::runtime_error("utterance queue is full");
+        }
+        applyCancellation(removed, skips, writingCancelled);
+        return id;
+    }
+
+    size_t Speaker::cancelUtterances(const int &maxPriority)
+    {
+        std::vector<std::shared_ptr<Utterance>> removed;
+        std::vector<PlaybackRange> skips;
+        bool writingCancelled = false;
+        size_t count = utterances.cancel(maxPriority, removed, skips, writingCancelled);
+        applyCancellation(removed, skips, writingCancelled);
+        return count;
+    }
+
+    uint64_t Speaker::beginText(const uint16_t &speakerId, const float &speechRate, const int &priority, const bool &interrupt, const TextCallback &onDone)
+    {
+        if (!frontend.loaded())
+        {
+            throw std::runtime_error("Text frontend dictionary not loaded");
+        }
+        auto session = std::make_shared<TextSession>();
+        session->id = nextTextId++;
+        session->speakerId = speakerId;
+        session->speechRate = speechRate;
+        session->priority = priority;
+        session->interrupt = interrupt;
+        session->onDone = onDone;
+        std::lock_guard<std::mutex> lock(textMutex);
+        textSessions[session->id] = session;
+        return session->id;
+    }
+
+    std::shared_ptr<TextSession> Speaker::findText(const uint64_t &id)
+    {
+        std::lock_guard<std::mutex> lock(textMutex);
+        auto it = textSessions.find(id);
+        if (it == textSessions.end())
+        {
+            throw std::runtime_error("text session not found");
+        }
+        return it->second;
+    }
+
+    size_t Speaker::appendText(const uint64_t &id, const std::string &fragment)
+    {
+        std::shared_ptr<TextSession> session = findText(id);
+        std::lock_guard<std::mutex> appendLock(session->appendMutex);
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (session->cancelled || session->ended)
+            {
+                return 0;
+            }
+            if (!session->hasText && !fragment.empty())
+            {
+                session->hasText = true;
+                session->firstTextTime = std::chrono::steady_clock::now();
+            }
+        }
+        std::vector<std::string> sentences;
+        session->segmenter.append(fragment, sentences);
+        enqueueSentences(session, sentences);
+        return sentences.size();
+    }
+
+    void Speaker::endText(const uint64_t &id)
+    {
+        std::shared_ptr<TextSession> session = findText(id);
+        {
+            std::lock_guard<std::mutex> appendLock(session->appendMutex);
+            bool cancelled;
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                if (session->ended)
+                {
+                    return;
+                }
+                cancelled = session->cancelled;
+            }
+            std::vector<std::string> sentences;
+            if (!cancelled)
+            {
+                session->segmenter.finish(sentences);
+            }
+            try
+            {
+                enqueueSentences(session, sentences);
+            }
+            catch (const std::exception &e)
+            {
+                // 队列已满时最后一句无法入队，会话以失败结束
+                std::lock_guard<std::mutex> lock(session->mutex);
+                session->error = e.what();
+            }
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->ended = true;
+        }
+        notifyText(session);
+    }
+
+    size_t Speaker::cancelText(const uint64_t &id)
+    {
+        std::shared_ptr<TextSession> session = findText(id);
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->cancelled = true;
+            session->ended = true;
+        }
+        size_t count = cancelSentences(session);
+        notifyText(session);
+        return count;
+    }
+
+    // 取消会话的排队与在途语句
+    size_t Speaker::cancelSentences(const std::shared_ptr<TextSession> &session)
+    {
+        uint64_t textId = session->id;
+        std::vector<std::shared_ptr<Utterance>> removed;
+        std::vector<PlaybackRange> skips;
+        bool writingCancelled = false;
+        size_t count = utterances.cancelIf([textId](const Utterance &utterance) { return utterance.textId == textId; }, removed, skips, writingCancelled);
+        applyCancellation(removed, skips, writingCancelled);
+        return count;
+    }
+
+    // 各句转换音素后加入发音队列（调用方持有appendMutex），仅会话首句按设置打断当前语句
+    void Speaker::enqueueSentences(const std::shared_ptr<TextSession> &session, const std::vector<std::string> &sentences)
+    {
+        for (const std::string &sentence : sentences)
+        {
+            auto utterance = std::make_shared<Utterance>();
+            frontend.textToPhonemeIds(sentence, utterance->phonemeIds);
+            if (utterance->phonemeIds.empty())
+            {
+                continue;
+            }
+            utterance->textId = session->id;
+            utterance->priority = session->priority;
+            utterance->speakerId = session->speakerId;
+            utterance->speechRate = session->speechRate;
+            // 回调执行期间队列或取消方持有语句，可直接引用
+            const Utterance *sentenceUtterance = utterance.get();
+            utterance->onDone = [this, session, sentenceUtterance](UtteranceState state, const SynthesisResult &result, int gapDuration, const std::string &error)
+            {
+                finishSentence(session, *sentenceUtterance, state, result, error);
+            };
+            bool interrupt;
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                if (session->cancelled)
+                {
+                    return;
+                }
+                interrupt = session->interrupt && session->sentences == 0;
+                session->sentences++;
+                session->pending++;
+            }
+            try
+            {
+                enqueue(std::move(utterance), interrupt);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                session->sentences--;
+                session->pending--;
+                throw;
+            }
+            // 入队期间会话被取消时，本句未被取消方看到，在此补充取消
+            bool cancelled;
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                cancelled = session->cancelled;
+            }
+            if (cancelled)
+            {
+                cancelSentences(session);
+                return;
+            }
+        }
+    }
+
+    // 会话中一句结束：累计结果，被取消（如被其它语句打断）时取消整个会话
+    void Speaker::finishSentence(const std::shared_ptr<TextSession> &session, const Utterance &utterance, UtteranceState state, const SynthesisResult &result, const std::string &error)
+    {
+        bool cancelSession = false;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            session->pending--;
+            session->result.inferDuration += result.inferDuration;
+            session->result.audioDuration += result.audioDuration;
+            if (utterance.started && session->hasText)
+            {
+                // 首句最先写入回放引擎，取最小值即为首句开始播放的时间
+                int firstChunkDuration = std::chrono::duration_cast<std::chrono::milliseconds>(utterance.firstWriteTime - session->firstTextTime).count();
+                if (session->result.firstChunkDuration == 0 || firstChunkDuration < session->result.firstChunkDuration)
+                {
+                    session->result.firstChunkDuration = firstChunkDuration;
+                }
+            }
+            if (state == UtteranceState::Cancelled && !session->cancelled)
+            {
+                session->cancelled = true;
+                cancelSession = true;
+            }
+            if (state == UtteranceState::Failed && session->error.empty())
+            {
+                session->error = error;
+            }
+        }
+        if (cancelSession)
+        {
+            cancelSentences(session);
+        }
+        notifyText(session);
+    }
+
+    // 会话已结束且各句均已结束时通知并移除会话
+    void Speaker::notifyText(const std::shared_ptr<TextSession> &session)
+    {
+        TextCallback onDone;
+        UtteranceState state;
+        SynthesisResult result;
+        size_t sentences;
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (!session->ended || session->pending > 0 || session->notified)
+            {
+                return;
+            }
+            session->notified = true;
+            state = session->cancelled ? UtteranceState::Cancelled : !session->error.empty() ? UtteranceState::Failed : UtteranceState::Completed;
+            result = session->result;
+            sentences = session->sentences;
+            error = session->error;
+            onDone = std::move(session->onDone);
+        }
+        {
+            std::lock_guard<std::mutex> lock(textMutex);
+            textSessions.erase(session->id);
+        }
+        if (onDone)
+        {
+            onDone(state, result, sentences, state == UtteranceState::Failed ? error : "");
+        }
+    }
+
+    // 发音线程：按优先级取出语句分句流式合成并写入回放引擎；
+    // 流水线模式下写入后不等待播放，已合成未播放的音频超出预合成上限时才等待，
+    // 逐句模式下等待本句播放完成后再合成下一句
+    void Speaker::processUtterances()
+    {
+        utteranceInference = true;
+        while (std::shared_ptr<Utterance> utterance = utterances.pop())
+        {
+            {
+                std::lock_guard<std::mutex> lock(terminateMutex);
+                writingUtterance = utterance.get();
+            }
+            SynthesisResult result{};
+            std::string error;
+            try
+            {
+                synthesizeStream(utterance->phonemeIds, utterance->speakerId, utterance->speechRate, [this, &utterance](std::vector<int16_t> &chunk, const SynthesisResult &chunkResult)
+                                 {
+                                     if (lookaheadSamples > 0)
+                                     {
+                                         playback.waitQueuedBelow(lookaheadSamples, utterance->cancelled);
+                                     }
+                                     bool first = !utterance->started;
+                                     if (!utterances.beginWrite(*utterance, playback.enqueuedPosition()))
+                                     {
+                                         return false;
+                                     }
+                                     if (first)
+                                     {
+                                         utterance->firstWriteTime = std::chrono::steady_clock::now();
+                                     }
+                                     playback.enqueue(chunk.data(), chunk.size());
+                                     return !utterance->cancelled; },
+                                 result);
+            }
+            catch (const std::exception &e)
+            {
+                error = e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(terminateMutex);
+                writingUtterance = nullptr;
+            }
+            utterance->result = result;
+            utterance->error = error;
+            PlaybackRange skip;
+            if (utterances.endWrite(*utterance, playback.enqueuedPosition(), skip))
+            {
+                // 被取消导致的推理终止不视为失败；以实际结束位置收窄取消时登记的跳过区间
+                if (utterance->started)
+                {
+                    playback.skip(skip.begin, skip.end);
+                }
+                if (utterances.finish(utterance) && utterance->onDone)
+                {
+                    utterance->onDone(UtteranceState::Cancelled, utterance->result, 0, "");
+                }
+                continue;
+            }
+            if (lookaheadSamples == 0)
+            {
+                utterances.waitFinished(utterance);
+            }
+        }
+    }
+
+    // 完成线程：按写入顺序等待各语句播放完成后通知，并统计相邻语句间的播放停顿
+    void Speaker::processCompletions()
+    {
+        std::chrono::steady_clock::time_point lastPlayedTime;
+        bool hasLastPlayed = false;
+        while (std::shared_ptr<Utterance> utterance = utterances.front())
+        {
+            playback.waitPlayed(utterance->end);
+            auto playedTime = std::chrono::steady_clock::now();
+            if (!utterances.finish(utterance))
+            {
+                continue;
+            }
+            UtteranceState state = UtteranceState::Completed;
+            if (utterance->cancelled)
+            {
+                state = UtteranceState::Cancelled;
+            }
+            else if (!utterance->error.empty())
+            {
+                state = UtteranceState::Failed;
+            }
+            // 上一句播完时本句已在排队但尚未写入音频，期间即为停顿
+            int gapDuration = 0;
+            if (hasLastPlayed && utterance->started && utterance->enqueueTime < lastPlayedTime && utterance->firstWriteTime > lastPlayedTime)
+            {
+                gapDuration = std::chrono::duration_cast<std::chrono::milliseconds>(utterance->firstWriteTime - lastPlayedTime).count();
+            }
+            if (state == UtteranceState::Completed)
+            {
+                lastPlayedTime = playedTime;
+                hasLastPlayed = true;
+            }
+            if (utterance->onDone)
+            {
+                utterance->onDone(state, utterance->result, gapDuration, state == UtteranceState::Failed ? utterance->error : "");
+            }
+        }
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,290 @@
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "synthesis_cache.hpp"
+
+namespace speaker
+{
+
+    // 持久化文件格式：文件头 + 顺序追加的记录
+    // 记录：uint32 键长度 | uint32 采样数 | 键（8字节对齐）| int16采样（8字节对齐）
+    static constexpr char FILE_MAGIC[8] = {'M', 'O', 'S', 'S', 'P', 'C', 'M', '1'};
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint64_t fingerprint; // 模型指纹
+        uint64_t used;        // 已写入的字节数（含文件头）
+        uint64_t entries;     // 记录数
+    };
+
+    struct RecordHeader
+    {
+        uint32_t keySize;
+        uint32_t samples;
+    };
+
+    static size_t alignSize(size_t size)
+    {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    SynthesisCache::~SynthesisCache()
+    {
+        close();
+    }
+
+    void SynthesisCache::open(const CacheConfig &config, uint64_t fingerprint)
+    {
+        close();
+        std::lock_guard<std::mutex> lock(mutex);
+        memoryCapacity = static_cast<size_t>(config.memoryCapacity) * 1024 * 1024;
+        if (!config.filePath.empty() && config.fileCapacity > 0)
+        {
+            openFile(config.filePath, static_cast<size_t>(config.fileCapacity) * 1024 * 1024, fingerprint);
+        }
+    }
+
+    void SynthesisCache::close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        memoryEntries.clear();
+        memoryIndex.clear();
+        memorySize = 0;
+        memoryCapacity = 0;
+        fileIndex.clear();
+#ifndef _WIN32
+        if (mapping != nullptr)
+        {
+            msync(mapping, mappingSize, MS_SYNC);
+            munmap(mapping, mappingSize);
+        }
+        if (fileDescriptor >= 0)
+        {
+            ::close(fileDescriptor);
+        }
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+        fileDescriptor = -1;
+    }
+
+    void SynthesisCache::openFile(const std::string &filePath, size_t capacity, uint64_t fingerprint)
+    {
+#ifdef _WIN32
+        throw std::runtime_error("synthesis cache file is not supported on this platform");
+#else
+        fileDescriptor = ::open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fileDescriptor < 0)
+        {
+            throw std::runtime_error("synthesis cache file open failed: " + filePath);
+        }
+        // 记录追加是对映射区域的读改写，同一文件只允许一个缓存实例（同进程或跨进程）打开，锁随描述符关闭释放
+        if (flock(fileDescriptor, LOCK_EX | LOCK_NB) != 0)
+        {
+            ::close(fileDescriptor);
+            fileDescriptor = -1;
+            throw std::runtime_error("synthesis cache file is in use by another instance: " + filePath);
+        }
+        struct stat fileStat;
+        fstat(fileDescriptor, &fileStat);
+        // 已有文件沿用其容量，避免截断已保存的记录
+        size_t fileSize = static_cast<size_t>(fileStat.st_size);
+        mappingSize = fileSize > sizeof(FileHeader) ? fileSize : capacity;
+        if (fileSize != mappingSize && ftruncate(fileDescriptor, mappingSize) != 0)
+        {
+            ::close(fileDescriptor);
+            fileDescriptor = -1;
+            throw std::runtime_error("synthesis cache file resize failed: " + filePath);
+        }
+        void *address = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+        if (address == MAP_FAILED)
+        {
+            ::close(fileDescriptor);
+            fileDescriptor = -1;
+            throw std::runtime_error("synthesis cache file mmap failed: " + filePath);
+        }
+        mapping = static_cast<uint8_t *>(address);
+
+        FileHeader *header = reinterpret_cast<FileHeader *>(mapping);
+        if (std::memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+            header->fingerprint != fingerprint ||
+            header->used < sizeof(FileHeader) || header->used > mappingSize)
+        {
+            resetFile(fingerprint);
+            return;
+        }
+        // 重建索引，键直接引用映射区域
+        size_t offset = sizeof(FileHeader);
+        while (offset + sizeof(RecordHeader) <= header->used)
+        {
+            const RecordHeader *record = reinterpret_cast<const RecordHeader *>(mapping + offset);
+            size_t keyOffset = offset + sizeof(RecordHeader);
+            size_t audioOffset = keyOffset + alignSize(record->keySize);
+            size_t nextOffset = audioOffset + alignSize(record->samples * sizeof(int16_t));
+            if (nextOffset > header->used)
+            {
+                break;
+            }
+            std::string_view key(reinterpret_cast<const char *>(mapping + keyOffset), record->keySize);
+            fileIndex[key] = {reinterpret_cast<const int16_t *>(mapping + audioOffset), record->samples};
+            offset = nextOffset;
+        }
+        header->used = offset;
+        header->entries = fileIndex.size();
+#endif
+    }
+
+    void SynthesisCache::resetFile(uint64_t fingerprint)
+    {
+        FileHeader *header = reinterpret_cast<FileHeader *>(mapping);
+        std::memcpy(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header->fingerprint = fingerprint;
+        header->used = sizeof(FileHeader);
+        header->entries = 0;
+        fileIndex.clear();
+    }
+
+    std::string SynthesisCache::makeKey(const PhonemeIdsView &phonemeIds, uint16_t speakerId, float speechRate, float noiseScale, float lengthScale, float noiseW)
+    {
+        const float scales[] = {speechRate, noiseScale, lengthScale, noiseW};
+        std::string key;
+        key.resize(sizeof(speakerId) + sizeof(scales) + phonemeIds.size() * sizeof(int64_t));
+        char *data = &key[0];
+        std::memcpy(data, &speakerId, sizeof(speakerId));
+        data += sizeof(speakerId);
+        std::memcpy(data, scales, sizeof(scales));
+        data += sizeof(scales);
+        // 键中音素ID统一按int64存储，与输入来源无关，持久化文件格式保持不变
+        for (size_t i = 0; i < phonemeIds.size(); i++)
+        {
+            int64_t phonemeId = phonemeIds[i];
+            std::memcpy(data + i * sizeof(int64_t), &phonemeId, sizeof(int64_t));
+        }
+        return key;
+    }
+
+    uint64_t SynthesisCache::hash(const void *data, size_t size, uint64_t seed)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        uint64_t value = seed;
+        for (size_t i = 0; i < size; i++)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ULL;
+        }
+        return value;
+    }
+
+    bool SynthesisCache::lookup(const std::string &key, std::vector<int16_t> &audioBuffer)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto memoryIt = memoryIndex.find(key);
+        if (memoryIt != memoryIndex.end())
+        {
+            memoryEntries.splice(memoryEntries.begin(), memoryEntries, memoryIt->second);
+            const std::vector<int16_t> &audio = memoryIt->second->audio;
+            audioBuffer.insert(audioBuffer.end(), audio.begin(), audio.end());
+            hits++;
+            memoryHits++;
+            return true;
+        }
+        auto fileIt = fileIndex.find(key);
+        if (fileIt != fileIndex.end())
+        {
+            const FileRecord &record = fileIt->second;
+            audioBuffer.insert(audioBuffer.end(), record.audio, record.audio + record.samples);
+            hits++;
+            fileHits++;
+            return true;
+        }
+        misses++;
+        return false;
+    }
+
+    void SynthesisCache::insert(const std::string &key, const int16_t *data, size_t samples)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // 持久化文件写穿，重启后仍可命中；已写入文件的条目无需再占用内存
+        if (mapping != nullptr)
+        {
+            insertFile(key, data, samples);
+            if (fileIndex.count(key) > 0)
+            {
+                return;
+            }
+        }
+        insertMemory(key, data, samples);
+    }
+
+    void SynthesisCache::insertMemory(const std::string &key, const int16_t *data, size_t samples)
+    {
+        size_t entrySize = key.size() + samples * sizeof(int16_t);
+        if (entrySize > memoryCapacity || memoryIndex.count(key) > 0)
+        {
+            return;
+        }
+        memoryEntries.push_front({key, std::vector<int16_t>(data, data + samples)});
+        memoryIndex[memoryEntries.front().key] = memoryEntries.begin();
+        memorySize += entrySize;
+        // 淘汰最久未使用的条目
+        while (memorySize > memoryCapacity)
+        {
+            MemoryEntry &entry = memoryEntries.back();
+            memorySize -= entry.key.size() + entry.audio.size() * sizeof(int16_t);
+            memoryIndex.erase(entry.key);
+            memoryEntries.pop_back();
+        }
+    }
+
+    void SynthesisCache::insertFile(const std::string &key, const int16_t *data, size_t samples)
+    {
+        if (fileIndex.count(key) > 0)
+        {
+            return;
+        }
+        FileHeader *header = reinterpret_cast<FileHeader *>(mapping);
+        size_t offset = header->used;
+        size_t keyOffset = offset + sizeof(RecordHeader);
+        size_t audioOffset = keyOffset + alignSize(key.size());
+        size_t nextOffset = audioOffset + alignSize(samples * sizeof(int16_t));
+        if (nextOffset > mappingSize)
+        {
+            return;
+        }
+        RecordHeader *record = reinterpret_cast<RecordHeader *>(mapping + offset);
+        record->keySize = static_cast<uint32_t>(key.size());
+        record->samples = static_cast<uint32_t>(samples);
+        std::memcpy(mapping + keyOffset, key.data(), key.size());
+        std::memcpy(mapping + audioOffset, data, samples * sizeof(int16_t));
+        // 记录写完后再推进已用偏移，进程中断时不会留下半条记录
+        header->used = nextOffset;
+        header->entries++;
+        std::string_view mappedKey(reinterpret_cast<const char *>(mapping + keyOffset), key.size());
+        fileIndex[mappedKey] = {reinterpret_cast<const int16_t *>(mapping + audioOffset), samples};
+    }
+
+    CacheStats SynthesisCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CacheStats cacheStats;
+        cacheStats.hits = hits;
+        cacheStats.misses = misses;
+        cacheStats.memoryHits = memoryHits;
+        cacheStats.fileHits = fileHits;
+        cacheStats.memoryEntries = memoryEntries.size();
+        cacheStats.memorySize = memorySize;
+        cacheStats.fileEntries = fileIndex.size();
+        cacheStats.fileSize = mapping != nullptr ? reinterpret_cast<const FileHeader *>(mapping)->used : 0;
+        return cacheStats;
+    }
+
+}
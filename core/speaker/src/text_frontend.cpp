@@ -0,0 +1,802 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "text_frontend.hpp"
+
+namespace speaker
+{
+
+    // 二进制词典格式：文件头 | 字典树单元 | 词条 | 音节ID | 音节 | 注音字符串池，各段8字节对齐
+    static constexpr char DICTIONARY_MAGIC[8] = {'M', 'O', 'S', 'S', 'D', 'I', 'C', '1'};
+
+    struct DictionaryHeader
+    {
+        char magic[8];
+        uint32_t unitCount;
+        uint32_t entryCount;
+        uint32_t syllableIdCount;
+        uint32_t syllableCount;
+        uint32_t stringPoolSize;
+        float minLogFrequency; // 未登录字的对数词频
+    };
+
+    struct DictionaryLayout
+    {
+        size_t units;
+        size_t entries;
+        size_t syllableIds;
+        size_t syllables;
+        size_t stringPool;
+        size_t size;
+    };
+
+    static size_t alignSize(size_t size)
+    {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    template <typename EntryType, typename SyllableType>
+    static DictionaryLayout computeLayout(const DictionaryHeader &header)
+    {
+        DictionaryLayout layout;
+        layout.units = alignSize(sizeof(DictionaryHeader));
+        layout.entries = layout.units + alignSize(header.unitCount * sizeof(TrieUnit));
+        layout.syllableIds = layout.entries + alignSize(header.entryCount * sizeof(EntryType));
+        layout.syllables = layout.syllableIds + alignSize(header.syllableIdCount * sizeof(uint16_t));
+        layout.stringPool = layout.syllables + alignSize(header.syllableCount * sizeof(SyllableType));
+        layout.size = layout.stringPool + header.stringPoolSize;
+        return layout;
+    }
+
+    // 解码一个UTF-8字符，返回字节数
+    static size_t decodeUtf8(const std::string &text, size_t pos, char32_t &codepoint)
+    {
+        uint8_t lead = static_cast<uint8_t>(text[pos]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 1;
+        if (pos + length > text.size())
+        {
+            length = 1;
+        }
+        codepoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+        for (size_t i = 1; i < length; i++)
+        {
+            codepoint = (codepoint << 6) | (static_cast<uint8_t>(text[pos + i]) & 0x3F);
+        }
+        return length;
+    }
+
+    static size_t countUtf8(const std::string &text)
+    {
+        size_t count = 0;
+        for (size_t pos = 0; pos < text.size(); count++)
+        {
+            char32_t codepoint;
+            pos += decodeUtf8(text, pos, codepoint);
+        }
+        return count;
+    }
+
+    static bool isHan(char32_t codepoint)
+    {
+        return codepoint >= 0x4E00 && codepoint <= 0x9FFF;
+    }
+
+    // 拉丁字母读法
+    static const char *LATIN_TO_BOPOMOFO[26] = {
+        "ㄟˉ", "ㄅㄧˋ", "ㄙㄧˉ", "ㄉㄧˋ", "ㄧˋ", "ㄝˊㄈㄨˋ", "ㄐㄧˋ", "ㄝˇㄑㄩˋ", "ㄞˋ",
+        "ㄐㄟˋ", "ㄎㄟˋ", "ㄝˊㄛˋ", "ㄝˊㄇㄨˋ", "ㄣˉ", "ㄡˉ", "ㄆㄧˉ", "ㄎㄧㄡˉ", "ㄚˋ",
+        "ㄝˊㄙˋ", "ㄊㄧˋ", "ㄧㄡˉ", "ㄨㄧˉ", "ㄉㄚˋㄅㄨˋㄌㄧㄡˋ", "ㄝˉㄎㄨˋㄙˋ", "ㄨㄞˋ", "ㄗㄟˋ"};
+
+    TextFrontend::~TextFrontend()
+    {
+        close();
+    }
+
+    void TextFrontend::close()
+    {
+#ifndef _WIN32
+        if (mapping != nullptr)
+        {
+            munmap(mapping, mappingSize);
+        }
+        if (fileDescriptor >= 0)
+        {
+            ::close(fileDescriptor);
+        }
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+        fileDescriptor = -1;
+        units = nullptr;
+        entries = nullptr;
+        syllableIds = nullptr;
+    }
+
+    void TextFrontend::load(const std::string &dictPath, const std::vector<std::string> &symbols)
+    {
+        close();
+#ifdef _WIN32
+        throw std::runtime_error("text frontend dictionary is not supported on this platform");
+#else
+        fileDescriptor = ::open(dictPath.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            throw std::runtime_error("text frontend dictionary open failed: " + dictPath);
+        }
+        struct stat fileStat;
+        fstat(fileDescriptor, &fileStat);
+        mappingSize = static_cast<size_t>(fileStat.st_size);
+        void *address = mappingSize >= sizeof(DictionaryHeader)
+                            ? mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fileDescriptor, 0)
+                            : MAP_FAILED;
+        if (address == MAP_FAILED)
+        {
+            close();
+            throw std::runtime_error("text frontend dictionary mmap failed: " + dictPath);
+        }
+        mapping = static_cast<uint8_t *>(address);
+#endif
+        const DictionaryHeader *header = reinterpret_cast<const DictionaryHeader *>(mapping);
+        DictionaryLayout layout = computeLayout<Entry, Syllable>(*header);
+        if (std::memcmp(header->magic, DICTIONARY_MAGIC, sizeof(DICTIONARY_MAGIC)) != 0 || layout.size > mappingSize)
+        {
+            close();
+            throw std::runtime_error("invalid text frontend dictionary: " + dictPath);
+        }
+        units = reinterpret_cast<const TrieUnit *>(mapping + layout.units);
+        unitCount = header->unitCount;
+        entries = reinterpret_cast<const Entry *>(mapping + layout.entries);
+        syllableIds = reinterpret_cast<const uint16_t *>(mapping + layout.syllableIds);
+        minLogFrequency = header->minLogFrequency;
+
+        // 模型符号均为单字符，下标即音素ID
+        symbolIds.clear();
+        for (size_t i = 0; i < symbols.size(); i++)
+        {
+            char32_t codepoint;
+            if (!symbols[i].empty() && decodeUtf8(symbols[i], 0, codepoint) == symbols[i].size())
+            {
+                symbolIds.emplace(codepoint, static_cast<int64_t>(i));
+            }
+        }
+
+        // 注音到音素ID的转换只在加载时做一次
+        auto toPhonemeIds = [this](const std::string &bopomofo, std::vector<int64_t> &ids)
+        {
+            for (size_t pos = 0; pos < bopomofo.size();)
+            {
+                char32_t codepoint;
+                pos += decodeUtf8(bopomofo, pos, codepoint);
+                appendSymbol(codepoint, ids);
+            }
+        };
+        const Syllable *syllables = reinterpret_cast<const Syllable *>(mapping + layout.syllables);
+        const char *stringPool = reinterpret_cast<const char *>(mapping + layout.stringPool);
+        syllablePhonemeIds.clear();
+        syllableRanges.resize(header->syllableCount);
+        for (uint32_t i = 0; i < header->syllableCount; i++)
+        {
+            uint32_t begin = static_cast<uint32_t>(syllablePhonemeIds.size());
+            toPhonemeIds(std::string(stringPool + syllables[i].offset, syllables[i].length), syllablePhonemeIds);
+            syllableRanges[i] = {begin, static_cast<uint32_t>(syllablePhonemeIds.size())};
+        }
+        latinPhonemeIds.clear();
+        for (char32_t letter = 'a'; letter <= 'z'; letter++)
+        {
+            toPhonemeIds(LATIN_TO_BOPOMOFO[letter - 'a'], latinPhonemeIds[letter]);
+        }
+    }
+
+    void TextFrontend::appendSymbol(char32_t codepoint, std::vector<int64_t> &ids) const
+    {
+        auto it = symbolIds.find(codepoint);
+        if (it != symbolIds.end())
+        {
+            ids.push_back(it->second);
+        }
+    }
+
+    // 汉字片段分词：按词典构建有向无环图，动态规划求最大概率路径后逐词注音
+    void TextFrontend::appendSegment(const std::string &text, const std::vector<size_t> &offsets, size_t begin, size_t end, std::vector<int64_t> &ids) const
+    {
+        size_t count = end - begin;
+        std::vector<double> route(count + 1, 0.0);
+        std::vector<size_t> routeEnd(count + 1, 0);
+        std::vector<int64_t> routeEntry(count + 1, -1);
+        for (size_t i = count; i-- > 0;)
+        {
+            double best = -std::numeric_limits<double>::infinity();
+            bool singleMatched = false;
+            int32_t node = 0;
+            for (size_t k = i + 1; k <= count; k++)
+            {
+                // 逐字节转移一个字
+                bool matched = true;
+                for (size_t pos = offsets[begin + k - 1]; pos < offsets[begin + k]; pos++)
+                {
+                    uint32_t next = static_cast<uint32_t>(units[node].base) + static_cast<uint8_t>(text[pos]) + 1;
+                    if (next >= unitCount || units[next].check != node)
+                    {
+                        matched = false;
+                        break;
+                    }
+                    node = static_cast<int32_t>(next);
+                }
+                if (!matched)
+                {
+                    break;
+                }
+                uint32_t terminal = static_cast<uint32_t>(units[node].base);
+                if (terminal >= unitCount || units[terminal].check != node || units[terminal].base >= 0)
+                {
+                    continue;
+                }
+                int64_t entry = -units[terminal].base - 1;
+                double score = entries[entry].logFrequency + route[k];
+                singleMatched = singleMatched || k == i + 1;
+                if (score > best)
+                {
+                    best = score;
+                    routeEnd[i] = k;
+                    routeEntry[i] = entry;
+                }
+            }
+            // 未登录字单独成词
+            if (!singleMatched && minLogFrequency + route[i + 1] > best)
+            {
+                best = minLogFrequency + route[i + 1];
+                routeEnd[i] = i + 1;
+                routeEntry[i] = -1;
+            }
+            route[i] = best;
+        }
+        std::string unknown;
+        for (size_t i = 0; i < count; i = routeEnd[i])
+        {
+            if (routeEntry[i] < 0)
+            {
+                unknown.append(text, offsets[begin + i], offsets[begin + i + 1] - offsets[begin + i]);
+                continue;
+            }
+            const Entry &entry = entries[routeEntry[i]];
+            for (uint32_t j = 0; j < entry.syllableCount; j++)
+            {
+                const std::pair<uint32_t, uint32_t> &range = syllableRanges[syllableIds[entry.syllableOffset + j]];
+                ids.insert(ids.end(), syllablePhonemeIds.begin() + range.first, syllablePhonemeIds.begin() + range.second);
+            }
+        }
+        // 词典中没有读音的字无法发音，记录以便补充词典
+        if (!unknown.empty())
+        {
+            std::cerr << "text frontend: no reading for " << unknown << std::endl;
+        }
+    }
+
+    void TextFrontend::textToPhonemeIds(const std::string &text, std::vector<int64_t> &phonemeIds) const
+    {
+        if (!loaded())
+        {
+            throw std::runtime_error("text frontend dictionary not loaded");
+        }
+        std::string normalized = normalizeNumbers(text);
+        std::vector<char32_t> codepoints;
+        std::vector<size_t> offsets;
+        codepoints.reserve(normalized.size());
+        offsets.reserve(normalized.size() + 1);
+        for (size_t pos = 0; pos < normalized.size();)
+        {
+            char32_t codepoint;
+            offsets.push_back(pos);
+            pos += decodeUtf8(normalized, pos, codepoint);
+            codepoints.push_back(codepoint);
+        }
+        offsets.push_back(normalized.size());
+
+        std::vector<int64_t> ids;
+        ids.reserve(codepoints.size() * 4);
+        for (size_t i = 0; i < codepoints.size();)
+        {
+            char32_t codepoint = codepoints[i];
+            if (isHan(codepoint))
+            {
+                size_t end = i;
+                while (end < codepoints.size() && isHan(codepoints[end]))
+                {
+                    end++;
+                }
+                appendSegment(normalized, offsets, i, end, ids);
+                i = end;
+                continue;
+            }
+            if (codepoint == U'、' || codepoint == U'；' || codepoint == U'：')
+            {
+                appendSymbol(U'，', ids);
+            }
+            else if ((codepoint >= 'a' && codepoint <= 'z') || (codepoint >= 'A' && codepoint <= 'Z'))
+            {
+                const std::vector<int64_t> &letterIds = latinPhonemeIds.at(codepoint | 0x20);
+                ids.insert(ids.end(), letterIds.begin(), letterIds.end());
+            }
+            else
+            {
+                appendSymbol(codepoint, ids);
+            }
+            i++;
+        }
+
+        // 音素间插入空白符
+        phonemeIds.clear();
+        phonemeIds.reserve(ids.size() * 2);
+        for (const int64_t &id : ids)
+        {
+            phonemeIds.push_back(0);
+            phonemeIds.push_back(id);
+        }
+    }
+
+    // 四位以内整数读法
+    static std::string readSection(uint32_t number)
+    {
+        static const char *DIGITS[] = {"零", "一", "二", "三", "四", "五", "六", "七", "八", "九"};
+        static const char *UNITS[] = {"", "十", "百", "千"};
+        static const uint32_t POWERS[] = {1, 10, 100, 1000};
+        std::string result;
+        bool zero = false;
+        for (int position = 3; position >= 0; position--)
+        {
+            uint32_t digit = number / POWERS[position] % 10;
+            if (digit == 0)
+            {
+                zero = !result.empty();
+                continue;
+            }
+            if (zero)
+            {
+                result += DIGITS[0];
+                zero = false;
+            }
+            result += DIGITS[digit];
+            result += UNITS[position];
+        }
+        return result;
+    }
+
+    static std::string readDigits(const std::string &digits)
+    {
+        static const char *DIGITS[] = {"零", "一", "二", "三", "四", "五", "六", "七", "八", "九"};
+        std::string result;
+        for (const char &digit : digits)
+        {
+            result += DIGITS[digit - '0'];
+        }
+        return result;
+    }
+
+    static std::string readInteger(const std::string &digits)
+    {
+        static const char *SECTION_UNITS[] = {"", "万", "亿", "万亿"};
+        size_t start = digits.find_first_not_of('0');
+        if (start == std::string::npos)
+        {
+            return "零";
+        }
+        std::string number = digits.substr(start);
+        // 超出万亿量级按位读
+        if (number.size() > 16)
+        {
+            return readDigits(digits);
+        }
+        std::string result;
+        bool zero = false;
+        size_t sections = (number.size() + 3) / 4;
+        for (size_t i = 0; i < sections; i++)
+        {
+            size_t end = number.size() - (sections - 1 - i) * 4;
+            size_t begin = end >= 4 ? end - 4 : 0;
+            uint32_t section = static_cast<uint32_t>(std::stoul(number.substr(begin, end - begin)));
+            if (section == 0)
+            {
+                zero = true;
+                continue;
+            }
+            if (!result.empty() && (zero || section < 1000))
+            {
+                result += "零";
+            }
+            result += readSection(section);
+            result += SECTION_UNITS[sections - 1 - i];
+            zero = false;
+        }
+        // 十至十九省略"一"
+        if (result.rfind("一十", 0) == 0)
+        {
+            result = result.substr(std::string("一").size());
+        }
+        return result;
+    }
+
+    std::string TextFrontend::normalizeNumbers(const std::string &text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (size_t pos = 0; pos < text.size();)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(text[pos])))
+            {
+                result += text[pos++];
+                continue;
+            }
+            size_t end = pos;
+            while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end])))
+            {
+                end++;
+            }
+            std::string integer = text.substr(pos, end - pos);
+            std::string fraction;
+            if (end + 1 < text.size() && text[end] == '.' && std::isdigit(static_cast<unsigned char>(text[end + 1])))
+            {
+                size_t fractionEnd = end + 1;
+                while (fractionEnd < text.size() && std::isdigit(static_cast<unsigned char>(text[fractionEnd])))
+                {
+                    fractionEnd++;
+                }
+                fraction = text.substr(end + 1, fractionEnd - end - 1);
+                end = fractionEnd;
+            }
+            // 年份按位读（如"2023年"读作"二零二三年"）；JS文本清洗器去掉"年"后整数读作"二千零二十三"，两个前端在此有意不同
+            if (fraction.empty() && text.compare(end, std::string("年").size(), "年") == 0)
+            {
+                result += readDigits(integer);
+            }
+            else
+            {
+                result += readInteger(integer);
+                if (!fraction.empty())
+                {
+                    result += "点" + readDigits(fraction);
+                }
+            }
+            pos = end;
+        }
+        return result;
+    }
+
+    std::string TextFrontend::pinyinToBopomofo(const std::string &_pinyin)
+    {
+        // 注音转换表
+        static const std::vector<std::pair<std::regex, std::string>> BOPOMOFO_REPLACE = {
+            {std::regex("^m(\\d)$"), "mu$1"}, // 呣
+            {std::regex("^n(\\d)$"), "N$1"},  // 嗯
+            {std::regex("^r5$"), "er5"},      // 〜兒
+            {std::regex("iu"), "iou"},
+            {std::regex("ui"), "uei"},
+            {std::regex("ong"), "ung"},
+            {std::regex("^yi?"), "i"},
+            {std::regex("^wu?"), "u"},
+            {std::regex("iu"), "v"},
+            {std::regex("^([jqx])u"), "$1v"},
+            {std::regex("([iuv])n"), "$1en"},
+            {std::regex("^zhi?"), "Z"},
+            {std::regex("^chi?"), "C"},
+            {std::regex("^shi?"), "S"},
+            {std::regex("^([zcsr])i"), "$1"},
+            {std::regex("ai"), "A"},
+            {std::regex("ei"), "I"},
+            {std::regex("ao"), "O"},
+            {std::regex("ou"), "U"},
+            {std::regex("ang"), "K"},
+            {std::regex("eng"), "G"},
+            {std::regex("an"), "M"},
+            {std::regex("en"), "N"},
+            {std::regex("er"), "R"},
+            {std::regex("eh"), "E"},
+            {std::regex("([iv])e"), "$1E"},
+            {std::regex("1$"), ""}};
+        static const std::map<char32_t, std::string> BOPOMOFO_TABLE = {
+            {'b', "ㄅ"}, {'p', "ㄆ"}, {'m', "ㄇ"}, {'f', "ㄈ"},
+            {'d', "ㄉ"}, {'t', "ㄊ"}, {'n', "ㄋ"}, {'l', "ㄌ"},
+            {'g', "ㄍ"}, {'k', "ㄎ"}, {'h', "ㄏ"}, {'j', "ㄐ"},
+            {'q', "ㄑ"}, {'x', "ㄒ"}, {'Z', "ㄓ"}, {'C', "ㄔ"},
+            {'S', "ㄕ"}, {'r', "ㄖ"}, {'z', "ㄗ"}, {'c', "ㄘ"},
+            {'s', "ㄙ"}, {'i', "ㄧ"}, {'u', "ㄨ"}, {'v', "ㄩ"},
+            {'a', "ㄚ"}, {'o', "ㄛ"}, {'e', "ㄜ"}, {'E', "ㄝ"},
+            {'A', "ㄞ"}, {'I', "ㄟ"}, {'O', "ㄠ"}, {'U', "ㄡ"},
+            {'M', "ㄢ"}, {'N', "ㄣ"}, {'K', "ㄤ"}, {'G', "ㄥ"},
+            {'R', "ㄦ"}, {'2', "ˊ"}, {'3', "ˇ"}, {'4', "ˋ"},
+            {'0', "˙"}, {U'ê', "ㄝ"}};
+
+        std::string pinyin = _pinyin;
+        pinyin.erase(std::remove(pinyin.begin(), pinyin.end(), '1'), pinyin.end());
+        for (const auto &[findRe, replace] : BOPOMOFO_REPLACE)
+        {
+            pinyin = std::regex_replace(pinyin, findRe, replace);
+        }
+        std::string bopomofo;
+        for (size_t pos = 0; pos < pinyin.size();)
+        {
+            char32_t codepoint;
+            size_t length = decodeUtf8(pinyin, pos, codepoint);
+            auto it = BOPOMOFO_TABLE.find(codepoint);
+            bopomofo += it != BOPOMOFO_TABLE.end() ? it->second : pinyin.substr(pos, length);
+            pos += length;
+        }
+        return bopomofo;
+    }
+
+    // 双数组字典树构建器
+    class TrieBuilder
+    {
+    public:
+        explicit TrieBuilder(const std::vector<std::string> &_keys) : keys(_keys) {}
+
+        std::vector<TrieUnit> build()
+        {
+            units.assign(1024, {0, -1});
+            usedBase.assign(units.size(), false);
+            units[0].check = -2;
+            if (!keys.empty())
+            {
+                insert(0, keys.size(), 0, 0);
+            }
+            size_t size = units.size();
+            while (size > 1 && units[size - 1].check == -1)
+            {
+                size--;
+            }
+            units.resize(size);
+            return units;
+        }
+
+    private:
+        void ensure(size_t size)
+        {
+            if (units.size() < size)
+            {
+                size_t newSize = std::max(size, units.size() * 2);
+                units.resize(newSize, {0, -1});
+                usedBase.resize(newSize, false);
+            }
+        }
+
+        int32_t findBase(const std::vector<int> &codes)
+        {
+            while (nextCheckPos < units.size() && units[nextCheckPos].check != -1)
+            {
+                nextCheckPos++;
+            }
+            for (size_t position = std::max<size_t>(nextCheckPos, codes.front() + 1);; position++)
+            {
+                ensure(position + 1);
+                if (units[position].check != -1)
+                {
+                    continue;
+                }
+                size_t base = position - codes.front();
+                if (base < 1 || usedBase[base])
+                {
+                    continue;
+                }
+                ensure(base + codes.back() + 1);
+                bool available = true;
+                for (const int &code : codes)
+                {
+                    if (units[base + code].check != -1)
+                    {
+                        available = false;
+                        break;
+                    }
+                }
+                if (available)
+                {
+                    return static_cast<int32_t>(base);
+                }
+            }
+        }
+
+        // 键区间[begin, end)在depth处共享前缀，node为前缀对应节点
+        void insert(size_t begin, size_t end, size_t depth, int32_t node)
+        {
+            std::vector<int> codes;
+            std::vector<std::pair<size_t, size_t>> ranges;
+            size_t i = begin;
+            // 有序键中最短的在前，结束符编码为0
+            if (keys[i].size() == depth)
+            {
+                codes.push_back(0);
+                ranges.push_back({i, i + 1});
+                i++;
+            }
+            while (i < end)
+            {
+                int code = static_cast<uint8_t>(keys[i][depth]) + 1;
+                size_t j = i;
+                while (j < end && static_cast<uint8_t>(keys[j][depth]) + 1 == code)
+                {
+                    j++;
+                }
+                codes.push_back(code);
+                ranges.push_back({i, j});
+                i = j;
+            }
+            int32_t base = findBase(codes);
+            units[node].base = base;
+            usedBase[base] = true;
+            for (const int &code : codes)
+            {
+                units[base + code].check = node;
+            }
+            for (size_t k = 0; k < codes.size(); k++)
+            {
+                if (codes[k] == 0)
+                {
+                    units[base].base = -static_cast<int32_t>(ranges[k].first) - 1;
+                }
+                else
+                {
+                    insert(ranges[k].first, ranges[k].second, depth + 1, base + codes[k]);
+                }
+            }
+        }
+
+        const std::vector<std::string> &keys;
+        std::vector<TrieUnit> units;
+        std::vector<bool> usedBase;
+        size_t nextCheckPos = 1;
+    };
+
+    void TextFrontend::buildDictionary(const std::string &lexiconPath, const std::string &dictPath)
+    {
+        std::ifstream lexicon(lexiconPath);
+        if (!lexicon.is_open())
+        {
+            throw std::runtime_error("lexicon open failed: " + lexiconPath);
+        }
+        // std::map按字节序排序，与字典树构建要求一致；重复词条保留首条
+        std::map<std::string, std::pair<double, std::vector<std::string>>> words;
+        double totalFrequency = 0.0;
+        std::string line;
+        while (std::getline(lexicon, line))
+        {
+            std::istringstream stream(line);
+            std::string word;
+            double frequency;
+            if (!(stream >> word >> frequency) || frequency <= 0.0)
+            {
+                continue;
+            }
+            std::vector<std::string> pinyins;
+            std::string pinyin;
+            while (stream >> pinyin)
+            {
+                pinyins.push_back(pinyin);
+            }
+            if (pinyins.size() != countUtf8(word) || words.count(word) > 0)
+            {
+                continue;
+            }
+            totalFrequency += frequency;
+            words.emplace(word, std::make_pair(frequency, std::move(pinyins)));
+        }
+        if (words.empty())
+        {
+            throw std::runtime_error("lexicon is empty: " + lexiconPath);
+        }
+        // 词典中只出现在多字词里的汉字补充单字词条（取所在词中词频最高者的读音，词频取最低词频），
+        // 避免罕见字与人名用字因无单字读音而不发音
+        double minFrequency = std::numeric_limits<double>::max();
+        std::map<std::string, std::pair<double, std::string>> characterReadings;
+        for (const auto &[word, value] : words)
+        {
+            minFrequency = std::min(minFrequency, value.first);
+            size_t index = 0;
+            for (size_t pos = 0; pos < word.size(); index++)
+            {
+                char32_t codepoint;
+                size_t length = decodeUtf8(word, pos, codepoint);
+                std::string character = word.substr(pos, length);
+                pos += length;
+                if (!isHan(codepoint) || words.count(character) > 0)
+                {
+                    continue;
+                }
+                auto it = characterReadings.find(character);
+                if (it == characterReadings.end() || value.first > it->second.first)
+                {
+                    characterReadings[character] = {value.first, value.second[index]};
+                }
+            }
+        }
+        for (const auto &[character, reading] : characterReadings)
+        {
+            totalFrequency += minFrequency;
+            words.emplace(character, std::make_pair(minFrequency, std::vector<std::string>{reading.second}));
+        }
+
+        std::vector<std::string> keys;
+        std::vector<Entry> dictEntries;
+        std::vector<uint16_t> dictSyllableIds;
+        std::map<std::string, uint16_t> syllableIndex;
+        std::vector<Syllable> dictSyllables;
+        std::string stringPool;
+        float minLogFrequency = 0.0f;
+        for (const auto &[word, value] : words)
+        {
+            Entry entry;
+            entry.logFrequency = static_cast<float>(std::log(value.first / totalFrequency));
+            entry.syllableOffset = static_cast<uint32_t>(dictSyllableIds.size());
+            entry.syllableCount = static_cast<uint32_t>(value.second.size());
+            minLogFrequency = std::min(minLogFrequency, entry.logFrequency);
+            for (const std::string &pinyin : value.second)
+            {
+                auto it = syllableIndex.find(pinyin);
+                if (it == syllableIndex.end())
+                {
+                    if (dictSyllables.size() > std::numeric_limits<uint16_t>::max())
+                    {
+                        throw std::runtime_error("too many syllables in lexicon");
+                    }
+                    // 一声无声调符号，补阴平符号
+                    std::string bopomofo = pinyinToBopomofo(pinyin);
+                    char32_t last = 0;
+                    for (size_t pos = 0; pos < bopomofo.size();)
+                    {
+                        pos += decodeUtf8(bopomofo, pos, last);
+                    }
+                    if (last >= 0x3105 && last <= 0x3129)
+                    {
+                        bopomofo += "ˉ";
+                    }
+                    dictSyllables.push_back({static_cast<uint32_t>(stringPool.size()), static_cast<uint32_t>(bopomofo.size())});
+                    stringPool += bopomofo;
+                    it = syllableIndex.emplace(pinyin, static_cast<uint16_t>(dictSyllables.size() - 1)).first;
+                }
+                dictSyllableIds.push_back(it->second);
+            }
+            keys.push_back(word);
+            dictEntries.push_back(entry);
+        }
+        std::vector<TrieUnit> trieUnits = TrieBuilder(keys).build();
+
+        DictionaryHeader header;
+        std::memcpy(header.magic, DICTIONARY_MAGIC, sizeof(DICTIONARY_MAGIC));
+        header.unitCount = static_cast<uint32_t>(trieUnits.size());
+        header.entryCount = static_cast<uint32_t>(dictEntries.size());
+        header.syllableIdCount = static_cast<uint32_t>(dictSyllableIds.size());
+        header.syllableCount = static_cast<uint32_t>(dictSyllables.size());
+        header.stringPoolSize = static_cast<uint32_t>(stringPool.size());
+        header.minLogFrequency = minLogFrequency;
+        DictionaryLayout layout = computeLayout<Entry, Syllable>(header);
+
+        std::vector<uint8_t> data(layout.size, 0);
+        std::memcpy(data.data(), &header, sizeof(header));
+        std::memcpy(data.data() + layout.units, trieUnits.data(), trieUnits.size() * sizeof(TrieUnit));
+        std::memcpy(data.data() + layout.entries, dictEntries.data(), dictEntries.size() * sizeof(Entry));
+        std::memcpy(data.data() + layout.syllableIds, dictSyllableIds.data(), dictSyllableIds.size() * sizeof(uint16_t));
+        std::memcpy(data.data() + layout.syllables, dictSyllables.data(), dictSyllables.size() * sizeof(Syllable));
+        std::memcpy(data.data() + layout.stringPool, stringPool.data(), stringPool.size());
+
+        std::ofstream dict(dictPath, std::ios::binary);
+        if (!dict.is_open())
+        {
+            throw std::runtime_error("dictionary open failed: " + dictPath);
+        }
+        dict.write(reinterpret_cast<const char *>(data.data()), data.size());
+    }
+
+}
@@ -0,0 +1,24 @@
+// 文本前端词典构建工具：将文本词典编译为可内存映射的二进制词典
+#include <iostream>
+
+#include "text_frontend.hpp"
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: build_dict <lexicon.txt> <output.dict>" << std::endl;
+        std::cerr << "lexicon line format: <word> <frequency> <pinyin1> <pinyin2> ..." << std::endl;
+        return 1;
+    }
+    try
+    {
+        speaker::TextFrontend::buildDictionary(argv[1], argv[2]);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
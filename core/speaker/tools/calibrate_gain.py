@@ -0,0 +1,107 @@
+"""
+标定固定输出增益（流式响度级）
+
+原生层默认按每段音频的峰值归一化，各段（流式合成的各分句）响度随其峰值浮动，且必须等整段合成完才能缩放。
+固定增益模式下模型输出乘以固定增益后经前瞻限幅输出，各段响度一致且可逐块输出。
+本工具以校准音素集合成，取各句峰值归一化增益的中位数作为固定增益（典型语句响度与原先一致，
+偶发的高峰值由限幅器处理），并报告该增益下的限幅比例与各句响度离散程度。
+
+用法：
+    python tools/calibrate_gain.py --model moss.onnx --config moss.json --corpus calibration.txt --write
+"""
+import argparse
+import json
+import sys
+
+import numpy as np
+import onnxruntime as ort
+
+
+def load_phoneme_corpus(path):
+    """读取音素语料：每行一句，以空格分隔的音素ID"""
+    corpus = []
+    with open(path, "r", encoding="utf-8") as file:
+        for line in file:
+            ids = line.split()
+            if ids:
+                corpus.append([int(id) for id in ids])
+    if not corpus:
+        raise ValueError(f"corpus is empty: {path}")
+    return corpus
+
+
+def synthesize(session, phoneme_ids, noise_scale, length_scale, noise_w):
+    input_names = [input.name for input in session.get_inputs()]
+    feed = {
+        "input": np.array([phoneme_ids], dtype=np.int64),
+        "input_lengths": np.array([len(phoneme_ids)], dtype=np.int64),
+        "scales": np.array([noise_scale, length_scale, noise_w], dtype=np.float32),
+    }
+    if "sid" in input_names:
+        feed["sid"] = np.array([0], dtype=np.int64)
+    return session.run(None, feed)[0].reshape(-1)
+
+
+def active_rms_db(audio, sample_rate):
+    """有声帧（20ms帧能量高于最大帧能量-40dB）的均方根电平（dBFS，以int16满幅为0dB）"""
+    frame = max(1, sample_rate // 50)
+    count = len(audio) // frame
+    if count == 0:
+        return None
+    energy = np.mean(audio[:count * frame].reshape(count, frame).astype(np.float64) ** 2, axis=1)
+    active = energy[energy > energy.max() * 1e-4]
+    return float(10.0 * np.log10(np.mean(active) / 32768.0 ** 2 + 1e-20))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="calibrate fixed output gain for streaming loudness")
+    parser.add_argument("--model", required=True, help="onnx model path")
+    parser.add_argument("--config", required=True, help="model config json path")
+    parser.add_argument("--corpus", required=True, help="phoneme corpus (space separated ids per line)")
+    parser.add_argument("--noise-scale", type=float, default=0.667)
+    parser.add_argument("--length-scale", type=float, default=1.0)
+    parser.add_argument("--noise-w", type=float, default=0.8)
+    parser.add_argument("--write", action="store_true", help="write output_gain into the model config")
+    args = parser.parse_args()
+
+    with open(args.config, "r", encoding="utf-8") as file:
+        config = json.load(file)
+    data = config.get("data", {})
+    sample_rate = data.get("sampling_rate", 16000)
+    max_wav_value = data.get("max_wav_value", 32768)
+    threshold = max_wav_value * 0.966  # 与原生限幅阈值一致
+
+    options = ort.SessionOptions()
+    options.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+    session = ort.InferenceSession(args.model, options, providers=["CPUExecutionProvider"])
+    outputs = [synthesize(session, ids, args.noise_scale, args.length_scale, args.noise_w)
+               for ids in load_phoneme_corpus(args.corpus)]
+
+    peak_gains = [max_wav_value / max(0.01, float(np.max(np.abs(audio)))) for audio in outputs]
+    gain = float(np.median(peak_gains))
+
+    limited_samples = sum(int(np.count_nonzero(np.abs(audio) * gain > threshold)) for audio in outputs)
+    total_samples = sum(len(audio) for audio in outputs)
+    peak_levels = [active_rms_db(audio * peak_gain, sample_rate) for audio, peak_gain in zip(outputs, peak_gains)]
+    fixed_levels = [active_rms_db(audio * gain, sample_rate) for audio in outputs]
+    peak_levels = [level for level in peak_levels if level is not None]
+    fixed_levels = [level for level in fixed_levels if level is not None]
+
+    report = {
+        "utterances": len(outputs),
+        "outputGain": gain,
+        "peakGain": {"min": float(np.min(peak_gains)), "p50": gain, "max": float(np.max(peak_gains))},
+        "limitedSampleRatio": limited_samples / max(1, total_samples),
+        "limitedUtteranceRatio": float(np.mean([np.max(np.abs(audio)) * gain > threshold for audio in outputs])),
+        # 各句有声段电平的标准差，越小各句响度越一致
+        "levelStdDb": {"peakNormalized": float(np.std(peak_levels)), "fixedGain": float(np.std(fixed_levels))},
+    }
+    if args.write:
+        config.setdefault("data", {})["output_gain"] = gain
+        with open(args.config, "w", encoding="utf-8") as file:
+            json.dump(config, file, ensure_ascii=False, indent=2)
+    print(json.dumps(report, ensure_ascii=False, indent=2))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
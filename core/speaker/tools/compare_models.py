@@ -0,0 +1,202 @@
+"""
+vits模型精度与性能对比：以FP32模型为参考，对比量化模型的RTF与梅尔谱距离
+
+为排除随机采样的影响，对比时noise_scale与noise_w取0，两模型输出确定；
+量化可能改变时长预测，梅尔谱帧经DTW对齐后再计算距离。
+
+用法：
+    python tools/compare_models.py --reference moss.onnx --candidate moss.int8.onnx \\
+        --config moss.json --corpus calibration.txt --threads 4 --output report.json
+"""
+import argparse
+import json
+import os
+import platform
+import sys
+import time
+
+import numpy as np
+import onnxruntime as ort
+
+
+def load_phoneme_corpus(path):
+    """读取音素语料：每行一句，以空格分隔的音素ID"""
+    corpus = []
+    with open(path, "r", encoding="utf-8") as file:
+        for line in file:
+            ids = line.split()
+            if ids:
+                corpus.append([int(id) for id in ids])
+    if not corpus:
+        raise ValueError(f"corpus is empty: {path}")
+    return corpus
+
+
+def mel_filterbank(sample_rate, n_fft, n_mels):
+    """HTK刻度梅尔滤波器组"""
+    def hz_to_mel(hz):
+        return 2595.0 * np.log10(1.0 + hz / 700.0)
+
+    def mel_to_hz(mel):
+        return 700.0 * (10.0 ** (mel / 2595.0) - 1.0)
+
+    mel_points = np.linspace(hz_to_mel(0.0), hz_to_mel(sample_rate / 2), n_mels + 2)
+    bins = np.floor((n_fft + 1) * mel_to_hz(mel_points) / sample_rate).astype(int)
+    filters = np.zeros((n_mels, n_fft // 2 + 1), dtype=np.float32)
+    for m in range(1, n_mels + 1):
+        left, center, right = bins[m - 1], bins[m], bins[m + 1]
+        for k in range(left, center):
+            filters[m - 1, k] = (k - left) / max(1, center - left)
+        for k in range(center, right):
+            filters[m - 1, k] = (right - k) / max(1, right - center)
+    return filters
+
+
+def log_mel(audio, filters, n_fft=1024, hop_length=256):
+    """对数梅尔谱，形状为(帧数, 梅尔带数)"""
+    if len(audio) < n_fft:
+        audio = np.pad(audio, (0, n_fft - len(audio)))
+    window = np.hanning(n_fft).astype(np.float32)
+    frame_count = 1 + (len(audio) - n_fft) // hop_length
+    frames = np.stack([audio[i * hop_length:i * hop_length + n_fft] * window for i in range(frame_count)])
+    power = np.abs(np.fft.rfft(frames, axis=1)) ** 2
+    return np.log(np.maximum(power @ filters.T, 1e-10))
+
+
+def dct_matrix(n_mels, n_ceps):
+    """正交DCT-II，用于由对数梅尔谱求梅尔倒谱"""
+    n = np.arange(n_mels)
+    k = np.arange(n_ceps)[:, None]
+    matrix = np.cos(np.pi / n_mels * (n + 0.5) * k) * np.sqrt(2.0 / n_mels)
+    matrix[0] /= np.sqrt(2.0)
+    return matrix.T
+
+
+def dtw_path(cost):
+    """动态时间规整，返回对齐帧对"""
+    n, m = cost.shape
+    total = np.full((n + 1, m + 1), np.inf)
+    total[0, 0] = 0.0
+    for i in range(1, n + 1):
+        for j in range(1, m + 1):
+            total[i, j] = cost[i - 1, j - 1] + min(total[i - 1, j - 1], total[i - 1, j], total[i, j - 1])
+    path = []
+    i, j = n, m
+    while i > 0 and j > 0:
+        path.append((i - 1, j - 1))
+        step = np.argmin([total[i - 1, j - 1], total[i - 1, j], total[i, j - 1]])
+        if step == 0:
+            i, j = i - 1, j - 1
+        elif step == 1:
+            i -= 1
+        else:
+            j -= 1
+    return path[::-1]
+
+
+def spectral_distance(reference, candidate, filters, dct):
+    """返回DTW对齐后的对数梅尔谱平均L1距离与梅尔倒谱失真（dB）"""
+    reference_mel = log_mel(reference, filters)
+    candidate_mel = log_mel(candidate, filters)
+    reference_ceps = (reference_mel @ dct)[:, 1:]
+    candidate_ceps = (candidate_mel @ dct)[:, 1:]
+    cost = np.sqrt(((reference_ceps[:, None, :] - candidate_ceps[None, :, :]) ** 2).sum(axis=2))
+    path = dtw_path(cost)
+    rows = np.array([p[0] for p in path])
+    cols = np.array([p[1] for p in path])
+    mel_distance = float(np.mean(np.abs(reference_mel[rows] - candidate_mel[cols])))
+    mcd = float(np.mean(10.0 / np.log(10.0) * np.sqrt(2.0) * cost[rows, cols]))
+    return mel_distance, mcd
+
+
+def create_session(model_path, threads):
+    options = ort.SessionOptions()
+    options.intra_op_num_threads = threads
+    options.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+    return ort.InferenceSession(model_path, options, providers=["CPUExecutionProvider"])
+
+
+def synthesize(session, phoneme_ids, length_scale):
+    input_names = [input.name for input in session.get_inputs()]
+    feed = {
+        "input": np.array([phoneme_ids], dtype=np.int64),
+        "input_lengths": np.array([len(phoneme_ids)], dtype=np.int64),
+        "scales": np.array([0.0, length_scale, 0.0], dtype=np.float32),
+    }
+    if "sid" in input_names:
+        feed["sid"] = np.array([0], dtype=np.int64)
+    start = time.perf_counter()
+    audio = session.run(None, feed)[0]
+    return audio.reshape(-1), time.perf_counter() - start
+
+
+def run_model(model_path, corpus, threads, iterations, sample_rate, length_scale):
+    session = create_session(model_path, threads)
+    synthesize(session, corpus[0], length_scale)  # 预热
+    outputs, rtfs = [], []
+    for iteration in range(iterations):
+        for index, phoneme_ids in enumerate(corpus):
+            audio, duration = synthesize(session, phoneme_ids, length_scale)
+            rtfs.append(duration / (len(audio) / sample_rate))
+            if iteration == 0:
+                outputs.append(audio)
+    return outputs, {
+        "path": model_path,
+        "size": os.path.getsize(model_path),
+        "rtf": {
+            "p50": float(np.percentile(rtfs, 50)),
+            "p90": float(np.percentile(rtfs, 90)),
+            "mean": float(np.mean(rtfs)),
+        },
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare quantized vits model against fp32 reference")
+    parser.add_argument("--reference", required=True, help="fp32 onnx model path")
+    parser.add_argument("--candidate", required=True, help="quantized onnx model path")
+    parser.add_argument("--config", required=True, help="model config json path")
+    parser.add_argument("--corpus", required=True, help="phoneme corpus (space separated ids per line)")
+    parser.add_argument("--threads", type=int, default=4, help="intra op threads")
+    parser.add_argument("--iterations", type=int, default=3)
+    parser.add_argument("--length-scale", type=float, default=1.0)
+    parser.add_argument("--output", help="report json path, default stdout")
+    args = parser.parse_args()
+
+    with open(args.config, "r", encoding="utf-8") as file:
+        sample_rate = json.load(file).get("data", {}).get("sampling_rate", 16000)
+    corpus = load_phoneme_corpus(args.corpus)
+
+    reference_outputs, reference = run_model(args.reference, corpus, args.threads, args.iterations, sample_rate, args.length_scale)
+    candidate_outputs, candidate = run_model(args.candidate, corpus, args.threads, args.iterations, sample_rate, args.length_scale)
+
+    filters = mel_filterbank(sample_rate, 1024, 80)
+    dct = dct_matrix(80, 13)
+    mel_distances, mcds, duration_ratios = [], [], []
+    for reference_audio, candidate_audio in zip(reference_outputs, candidate_outputs):
+        mel_distance, mcd = spectral_distance(reference_audio, candidate_audio, filters, dct)
+        mel_distances.append(mel_distance)
+        mcds.append(mcd)
+        duration_ratios.append(len(candidate_audio) / len(reference_audio))
+
+    report = {
+        "device": {"machine": platform.machine(), "processor": platform.processor(), "threads": args.threads},
+        "onnxruntime": ort.__version__,
+        "utterances": len(corpus),
+        "reference": reference,
+        "candidate": candidate,
+        "speedup": reference["rtf"]["mean"] / candidate["rtf"]["mean"],
+        "melDistance": {"mean": float(np.mean(mel_distances)), "max": float(np.max(mel_distances))},
+        "mcd": {"mean": float(np.mean(mcds)), "max": float(np.max(mcds))},
+        "durationRatio": {"mean": float(np.mean(duration_ratios)), "min": float(np.min(duration_ratios)),
+                          "max": float(np.max(duration_ratios))},
+    }
+    text = json.dumps(report, ensure_ascii=False, indent=2)
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as file:
+            file.write(text)
+    print(text)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,118 @@
+"""
+vits模型INT8量化
+
+动态量化仅量化权重（激活在推理时动态量化），无需校准数据；
+静态量化以校准音素集统计激活范围，生成QDQ格式模型。
+
+用法：
+    python tools/quantize_model.py --model moss.onnx --mode dynamic
+    python tools/quantize_model.py --model moss.onnx --mode static --calibration calibration.txt
+"""
+import argparse
+import json
+import os
+import sys
+import tempfile
+
+import numpy as np
+from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod, QuantFormat, QuantType,
+                                      quantize_dynamic, quantize_static)
+from onnxruntime.quantization.shape_inference import quant_pre_process
+
+
+def load_phoneme_corpus(path):
+    """读取音素语料：每行一句，以空格分隔的音素ID"""
+    corpus = []
+    with open(path, "r", encoding="utf-8") as file:
+        for line in file:
+            ids = line.split()
+            if ids:
+                corpus.append([int(id) for id in ids])
+    if not corpus:
+        raise ValueError(f"calibration corpus is empty: {path}")
+    return corpus
+
+
+def make_feed(phoneme_ids, noise_scale, length_scale, noise_w, multi_speaker):
+    """构造与原生推理一致的输入"""
+    feed = {
+        "input": np.array([phoneme_ids], dtype=np.int64),
+        "input_lengths": np.array([len(phoneme_ids)], dtype=np.int64),
+        "scales": np.array([noise_scale, length_scale, noise_w], dtype=np.float32),
+    }
+    if multi_speaker:
+        feed["sid"] = np.array([0], dtype=np.int64)
+    return feed
+
+
+class PhonemeCalibrationReader(CalibrationDataReader):
+    """以校准音素集逐句提供输入"""
+
+    def __init__(self, corpus, input_names, noise_scale, length_scale, noise_w):
+        multi_speaker = "sid" in input_names
+        self.feeds = iter([make_feed(ids, noise_scale, length_scale, noise_w, multi_speaker) for ids in corpus])
+
+    def get_next(self):
+        return next(self.feeds, None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="quantize vits model to int8")
+    parser.add_argument("--model", required=True, help="fp32 onnx model path")
+    parser.add_argument("--output", help="output path, default <model>.int8.onnx")
+    parser.add_argument("--mode", choices=["dynamic", "static"], default="dynamic")
+    parser.add_argument("--calibration", help="phoneme corpus for static quantization (space separated ids per line)")
+    parser.add_argument("--calibrate-method", choices=["minmax", "entropy", "percentile"], default="minmax")
+    parser.add_argument("--op-types", default="MatMul,Gemm,Conv",
+                        help="op types to quantize, comma separated (dynamic Conv is slow on some CPUs)")
+    parser.add_argument("--per-channel", action="store_true", help="per channel weight quantization")
+    parser.add_argument("--noise-scale", type=float, default=0.667)
+    parser.add_argument("--length-scale", type=float, default=1.0)
+    parser.add_argument("--noise-w", type=float, default=0.8)
+    args = parser.parse_args()
+
+    output_path = args.output or os.path.splitext(args.model)[0] + ".int8.onnx"
+    op_types = [op_type for op_type in args.op_types.split(",") if op_type]
+
+    with tempfile.TemporaryDirectory() as temp_dir:
+        # 预处理（符号形状推断与图优化）提升量化覆盖率
+        preprocessed_path = os.path.join(temp_dir, "preprocessed.onnx")
+        quant_pre_process(args.model, preprocessed_path, skip_symbolic_shape=False)
+
+        if args.mode == "dynamic":
+            quantize_dynamic(preprocessed_path, output_path,
+                             op_types_to_quantize=op_types,
+                             per_channel=args.per_channel,
+                             weight_type=QuantType.QInt8)
+        else:
+            if not args.calibration:
+                parser.error("--calibration is required for static quantization")
+            import onnx
+            input_names = [input.name for input in onnx.load(preprocessed_path).graph.input]
+            reader = PhonemeCalibrationReader(load_phoneme_corpus(args.calibration), input_names,
+                                              args.noise_scale, args.length_scale, args.noise_w)
+            calibrate_method = {
+                "minmax": CalibrationMethod.MinMax,
+                "entropy": CalibrationMethod.Entropy,
+                "percentile": CalibrationMethod.Percentile,
+            }[args.calibrate_method]
+            quantize_static(preprocessed_path, output_path, reader,
+                            quant_format=QuantFormat.QDQ,
+                            op_types_to_quantize=op_types,
+                            per_channel=args.per_channel,
+                            activation_type=QuantType.QUInt8,
+                            weight_type=QuantType.QInt8,
+                            calibrate_method=calibrate_method)
+
+    print(json.dumps({
+        "model": args.model,
+        "output": output_path,
+        "mode": args.mode,
+        "opTypes": op_types,
+        "sizeBefore": os.path.getsize(args.model),
+        "sizeAfter": os.path.getsize(output_path),
+    }, ensure_ascii=False, indent=2))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
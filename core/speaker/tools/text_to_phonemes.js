@@ -0,0 +1,43 @@
+/**
+ * 将文本语料转换为音素ID语料（每行一句，空格分隔），用于量化校准与模型对比
+ *
+ * 用法：node tools/text_to_phonemes.js <模型配置路径> <文本语料路径> [输出路径]
+ */
+import fs from "fs-extra";
+import _ from "lodash";
+import textCleaners from "../lib/text_cleaners/index.js";
+import ModelConfig from "../lib/ModelConfig.js";
+
+const [modelConfigPath, corpusPath, outputPath] = process.argv.slice(2);
+if(!modelConfigPath || !corpusPath) {
+    console.error("usage: node tools/text_to_phonemes.js <model config> <text corpus> [output]");
+    process.exit(1);
+}
+
+const modelConfig = new ModelConfig(fs.readJSONSync(modelConfigPath));
+const symbolMap = {};
+modelConfig.symbols.forEach((symbol, index) => symbolMap[symbol] = index);
+
+// 与Speaker的音素转换一致：文本清洗后查表，并在音素间插入空白符（ID为0）
+function textToPhonemeIds(text) {
+    text = modelConfig.textCleanerNames.reduce((str, cleanersName) => textCleaners[cleanersName] ? textCleaners[cleanersName](str) : str, text);
+    const phonemeIds = [];
+    for(let char of text) {
+        if(_.isUndefined(symbolMap[char]))
+            continue;
+        phonemeIds.push(0, symbolMap[char]);
+    }
+    return phonemeIds;
+}
+
+const lines = fs.readFileSync(corpusPath, "utf-8")
+    .split("\n")
+    .map(line => line.trim())
+    .filter(line => line)
+    .map(textToPhonemeIds)
+    .filter(phonemeIds => phonemeIds.length)
+    .map(phonemeIds => phonemeIds.join(" "));
+if(outputPath)
+    fs.writeFileSync(outputPath, lines.join("\n") + "\n");
+else
+    console.log(lines.join("\n"));